@@ -0,0 +1,85 @@
+#include "AllocationTracker.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Plain thread_local PODs: safe to touch from inside operator new
+    thread_local uint64_t threadAllocations = 0;
+    thread_local uint64_t threadBytes = 0;
+}
+
+namespace AllocationTracking {
+
+bool enabled() {
+#ifdef PORTFOLIO_ALLOCATION_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+Counters threadCounters() {
+    Counters counters;
+    counters.allocations = threadAllocations;
+    counters.bytes = threadBytes;
+    return counters;
+}
+
+Scope::Scope(const char* allocationsName, const char* bytesName)
+    : allocationsName_(allocationsName)
+    , bytesName_(bytesName)
+    , start_(threadCounters()) {}
+
+Scope::~Scope() {
+    Counters used = delta();
+    Profiling::recordCount(allocationsName_, used.allocations);
+    Profiling::recordCount(bytesName_, used.bytes);
+}
+
+Counters Scope::delta() const {
+    Counters now = threadCounters();
+    Counters used;
+    used.allocations = now.allocations - start_.allocations;
+    used.bytes = now.bytes - start_.bytes;
+    return used;
+}
+
+}
+
+#ifdef PORTFOLIO_ALLOCATION_TRACKING
+
+// Global replacements; every form of new funnels through trackedAllocate
+namespace {
+    void* trackedAllocate(std::size_t size) {
+        ++threadAllocations;
+        threadBytes += size;
+        return std::malloc(size ? size : 1);
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = trackedAllocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = trackedAllocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
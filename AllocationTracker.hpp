@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include "Profiler.hpp"
+
+// Opt-in heap allocation accounting. Building with
+// -DPORTFOLIO_ALLOCATION_TRACKING replaces the global operator new/delete
+// with versions that bump per-thread allocation and byte counters, and
+// enables ALLOCATION_SCOPE, which attributes the allocations made inside a
+// scope to a pipeline stage. Stage totals go through the Profiling counters
+// ("<stage>.allocations", "<stage>.bytes") and are written with the rest of
+// the profile at exit.
+//
+// Counts are inclusive: a stage's totals include every nested stage opened
+// inside it (rebalance_step contains risk_metrics, say), so stage totals do
+// not add up across levels. Counters are per thread, so a scope sees only
+// the allocations of the thread that opened it; work handed to
+// WorkStealingPool workers is not attributed to the caller's stage.
+namespace AllocationTracking {
+
+    struct Counters {
+        uint64_t allocations{0};
+        uint64_t bytes{0};
+    };
+
+    // True when the operator new hook is compiled in
+    bool enabled();
+
+    // Cumulative counters of the calling thread
+    Counters threadCounters();
+
+    class Scope {
+    public:
+        Scope(const char* allocationsName, const char* bytesName);
+        ~Scope();
+
+        // Allocations made so far inside this scope
+        Counters delta() const;
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* allocationsName_;
+        const char* bytesName_;
+        Counters start_;
+    };
+}
+
+#ifdef PORTFOLIO_ALLOCATION_TRACKING
+#define ALLOCATION_SCOPE(stage) ::AllocationTracking::Scope \
+    PROFILE_CONCAT(allocationScope_, __LINE__)(stage ".allocations", stage ".bytes")
+#else
+#define ALLOCATION_SCOPE(stage) ((void)0)
+#endif
@@ -0,0 +1,106 @@
+#include "AsyncWriter.hpp"
+#include <charconv>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+TextBuffer& TextBuffer::fixed(double value, int precision) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        // Only magnitudes beyond ~1e60 overflow the stack buffer
+        std::string wide(512, '\0');
+        result = std::to_chars(&wide[0], &wide[0] + wide.size(), value,
+                               std::chars_format::fixed, precision);
+        data_.append(wide.data(), result.ptr);
+        return *this;
+    }
+    data_.append(buffer, result.ptr);
+    return *this;
+}
+
+TextBuffer& TextBuffer::integer(long long value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    data_.append(buffer, result.ptr);
+    return *this;
+}
+
+AsyncFileWriter::AsyncFileWriter(size_t bufferBytes)
+    : bufferBytes_(bufferBytes)
+    , worker_(&AsyncFileWriter::run, this) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_one();
+    worker_.join();
+}
+
+void AsyncFileWriter::submit(const std::string& filename, FormatJob format) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Job{filename, std::move(format)});
+        ++pending_;
+    }
+    workAvailable_.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(lock, [this] { return pending_ == 0; });
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void AsyncFileWriter::writeFile(const std::string& filename, const TextBuffer& content, size_t bufferBytes) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(filename.c_str(), "wb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("Unable to open " + filename);
+    }
+    std::setvbuf(file.get(), nullptr, _IOFBF, bufferBytes);
+    const std::string& data = content.str();
+    if (std::fwrite(data.data(), 1, data.size(), file.get()) != data.size()) {
+        throw std::runtime_error("Failed writing " + filename);
+    }
+    if (std::fclose(file.release()) != 0) {
+        throw std::runtime_error("Failed closing " + filename);
+    }
+}
+
+// Private helper methods
+void AsyncFileWriter::run() {
+    TextBuffer buffer(bufferBytes_);
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        try {
+            buffer.clear();
+            job.format(buffer);
+            writeFile(job.filename, buffer, bufferBytes_);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_;
+        }
+        workDone_.notify_all();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Append-only text buffer with std::to_chars number formatting; replaces
+// ostream << with fixed/setprecision on the export paths.
+class TextBuffer {
+public:
+    explicit TextBuffer(size_t reserveBytes = 1 << 16) { data_.reserve(reserveBytes); }
+
+    TextBuffer& operator<<(const std::string& text) { data_.append(text); return *this; }
+    TextBuffer& operator<<(const char* text) { data_.append(text); return *this; }
+    TextBuffer& operator<<(char c) { data_.push_back(c); return *this; }
+
+    // Fixed notation with `precision` decimals (same output as std::fixed)
+    TextBuffer& fixed(double value, int precision);
+    TextBuffer& integer(long long value);
+
+    const std::string& str() const { return data_; }
+    size_t size() const { return data_.size(); }
+    void clear() { data_.clear(); }
+    std::string& bytes() { return data_; }
+
+private:
+    std::string data_;
+};
+
+// Background file writer. Jobs are queued by the optimization thread and
+// run on one writer thread, which formats into a reused buffer and writes
+// the file through a large stdio buffer. A job captures what it needs by
+// value, so formatting and I/O overlap with the next optimization step.
+// Errors are kept and rethrown by flush().
+class AsyncFileWriter {
+public:
+    using FormatJob = std::function<void(TextBuffer&)>;
+
+    explicit AsyncFileWriter(size_t bufferBytes = 1 << 20);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // Formats and writes `filename` in the background
+    void submit(const std::string& filename, FormatJob format);
+
+    // Blocks until every submitted file is written; rethrows the first error
+    void flush();
+
+    // Formats and writes on the calling thread
+    static void writeFile(const std::string& filename, const TextBuffer& content, size_t bufferBytes = 1 << 20);
+
+private:
+    struct Job {
+        std::string filename;
+        FormatJob format;
+    };
+
+    size_t bufferBytes_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    std::deque<Job> queue_;
+    size_t pending_{0};
+    bool stopping_{false};
+    std::exception_ptr error_;
+    std::thread worker_;
+
+    void run();
+};
@@ -0,0 +1,243 @@
+#include "BlackLitterman.hpp"
+#include "MatrixOperations.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+BlackLitterman::BlackLitterman(const SymmetricMatrix& covariance, const std::vector<double>& benchmarkWeights)
+    : BlackLitterman(covariance, benchmarkWeights, BlackLittermanParameters()) {}
+
+BlackLitterman::BlackLitterman(const SymmetricMatrix& covariance, const std::vector<double>& benchmarkWeights,
+                               const BlackLittermanParameters& parameters)
+    : parameters_(parameters)
+    , covariance_(covariance) {
+
+    if (!(parameters.tau > 0.0) || !(parameters.riskAversion > 0.0)) {
+        throw std::runtime_error("BlackLitterman: tau and risk aversion must be positive");
+    }
+    try {
+        cholesky_ = PackedCholesky(covariance_);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("BlackLitterman: covariance not positive definite: " + std::string(e.what()));
+    }
+    setBenchmarkWeights(benchmarkWeights);
+}
+
+BlackLitterman::View BlackLitterman::absoluteView(Size asset, double expectedReturn, double variance) {
+    View view;
+    view.assets.emplace_back(asset, 1.0);
+    view.expectedReturn = expectedReturn;
+    view.variance = variance;
+    return view;
+}
+
+BlackLitterman::View BlackLitterman::relativeView(Size longAsset, Size shortAsset, double outperformance,
+                                                  double variance) {
+    View view;
+    view.assets.emplace_back(longAsset, 1.0);
+    view.assets.emplace_back(shortAsset, -1.0);
+    view.expectedReturn = outperformance;
+    view.variance = variance;
+    return view;
+}
+
+void BlackLitterman::setViews(const std::vector<View>& views) {
+    for (const auto& view : views) {
+        for (const auto& entry : view.assets) {
+            if (entry.first >= covariance_.size()) {
+                throw std::runtime_error("BlackLitterman: view references asset " +
+                                         std::to_string(entry.first) + " out of range");
+            }
+        }
+    }
+    views_ = views;
+    omega_ = Matrix();
+    stale_ = true;
+}
+
+void BlackLitterman::setViews(const Matrix& P, const std::vector<double>& Q, const Matrix& omega) {
+    const Size K = P.rows();
+    if (P.columns() != covariance_.size() || Q.size() != K) {
+        throw std::runtime_error("BlackLitterman: P must be K x N and Q of length K");
+    }
+    if (!omega.empty() && (omega.rows() != K || omega.columns() != K)) {
+        throw std::runtime_error("BlackLitterman: Omega must be K x K");
+    }
+
+    std::vector<View> views(K);
+    for (Size k = 0; k < K; ++k) {
+        for (Size j = 0; j < P.columns(); ++j) {
+            if (P[k][j] != 0.0) views[k].assets.emplace_back(j, P[k][j]);
+        }
+        views[k].expectedReturn = Q[k];
+        views[k].variance = omega.empty() ? 0.0 : omega[k][k];
+    }
+    setViews(views);
+    omega_ = omega;
+}
+
+void BlackLitterman::addView(const View& view) {
+    std::vector<View> views = views_;
+    views.push_back(view);
+    Matrix omega = omega_;
+    setViews(views);
+
+    // An explicit Omega keeps its entries; the new view is uncorrelated
+    if (!omega.empty()) {
+        const Size K = views_.size();
+        omega_ = Matrix(K, K, 0.0);
+        for (Size k = 0; k + 1 < K; ++k) {
+            std::copy(omega[k], omega[k] + K - 1, omega_[k]);
+        }
+        omega_[K - 1][K - 1] = view.variance;
+    }
+}
+
+void BlackLitterman::clearViews() {
+    views_.clear();
+    omega_ = Matrix();
+    stale_ = true;
+}
+
+void BlackLitterman::setBenchmarkWeights(const std::vector<double>& benchmarkWeights) {
+    if (benchmarkWeights.size() != covariance_.size()) {
+        throw std::runtime_error("BlackLitterman: benchmark weights do not match the covariance");
+    }
+    impliedReturns_.resize(covariance_.size());
+    MatrixOperations::symv(covariance_, benchmarkWeights.data(), impliedReturns_.data());
+    for (double& value : impliedReturns_) {
+        value *= parameters_.riskAversion;
+    }
+    stale_ = true;
+}
+
+const std::vector<double>& BlackLitterman::posteriorReturns() {
+    if (stale_) refresh();
+    return posteriorReturns_;
+}
+
+void BlackLitterman::solvePosterior(const Real* b, Real* x) {
+    if (stale_) refresh();
+    const Size K = views_.size();
+    const double scale = 1.0 / (1.0 + parameters_.tau);
+
+    // P b before x (which may alias b) is overwritten
+    std::vector<double> projected(K);
+    for (Size k = 0; k < K; ++k) {
+        projected[k] = applyView(views_[k], b);
+    }
+
+    cholesky_.solve(b, x);
+    for (Size i = 0; i < covariance_.size(); ++i) {
+        x[i] *= scale;
+    }
+    if (K == 0) return;
+
+    woodburyCholesky_.solve(projected.data(), projected.data());
+    for (Size k = 0; k < K; ++k) {
+        for (const auto& entry : views_[k].assets) {
+            x[entry.first] += entry.second * projected[k] * scale * scale;
+        }
+    }
+}
+
+SymmetricMatrix BlackLitterman::posteriorCovariance() {
+    if (stale_) refresh();
+    const Size n = covariance_.size();
+    const Size K = views_.size();
+    const double tau = parameters_.tau;
+
+    // A^-1 U' one asset at a time: column i of sigmaP_
+    Matrix solved(K, n);
+    std::vector<double> column(K);
+    for (Size i = 0; i < n && K > 0; ++i) {
+        for (Size k = 0; k < K; ++k) column[k] = sigmaP_[k][i];
+        systemCholesky_.solve(column.data(), column.data());
+        for (Size k = 0; k < K; ++k) solved[k][i] = column[k];
+    }
+
+    SymmetricMatrix posterior(n);
+    for (Size i = 0; i < n; ++i) {
+        Real* row = posterior.row(i);
+        const Real* prior = covariance_.row(i);
+        for (Size j = i; j < n; ++j) {
+            row[j - i] = (1.0 + tau) * prior[j - i];
+        }
+        for (Size k = 0; k < K; ++k) {
+            MatrixOperations::axpy(-tau * tau * sigmaP_[k][i], solved[k] + i, row, n - i);
+        }
+    }
+    return posterior;
+}
+
+std::vector<double> BlackLitterman::optimalWeights() {
+    std::vector<double> weights = posteriorReturns();
+    solvePosterior(weights.data(), weights.data());
+    for (double& w : weights) {
+        w /= parameters_.riskAversion;
+    }
+    return weights;
+}
+
+// Private helper methods
+void BlackLitterman::refresh() {
+    const Size n = covariance_.size();
+    const Size K = views_.size();
+    const double tau = parameters_.tau;
+    posteriorReturns_ = impliedReturns_;
+    stale_ = false;
+    if (K == 0) return;
+
+    // U = Sigma P' from the columns each view references
+    sigmaP_ = Matrix(K, n, 0.0);
+    for (Size k = 0; k < K; ++k) {
+        if (views_[k].assets.empty()) {
+            stale_ = true;
+            throw std::runtime_error("BlackLitterman: view " + std::to_string(k) + " references no assets");
+        }
+        for (const auto& entry : views_[k].assets) {
+            MatrixOperations::addColumn(covariance_, entry.first, entry.second, sigmaP_[k]);
+        }
+    }
+
+    // A = tau P Sigma P' + Omega and H = A / tau^2 - P Sigma P' / (1 + tau)
+    SymmetricMatrix system(K), woodbury(K);
+    for (Size k = 0; k < K; ++k) {
+        for (Size l = k; l < K; ++l) {
+            double g = applyView(views_[k], sigmaP_[l]);
+            double omega = omega_.empty() ? 0.0 : omega_[k][l];
+            if (l == k) {
+                double variance = omega_.empty() ? views_[k].variance : omega_[k][k];
+                omega = variance > 0.0 ? variance : tau * g;
+            }
+            system(k, l) = tau * g + omega;
+            woodbury(k, l) = system(k, l) / (tau * tau) - g / (1.0 + tau);
+        }
+    }
+    try {
+        systemCholesky_ = PackedCholesky(system);
+        woodburyCholesky_ = PackedCholesky(woodbury);
+    }
+    catch (const std::exception& e) {
+        stale_ = true;
+        throw std::runtime_error("BlackLitterman: view system not positive definite: " + std::string(e.what()));
+    }
+
+    // mu = pi + tau U A^-1 (Q - P pi)
+    std::vector<double> residual(K);
+    for (Size k = 0; k < K; ++k) {
+        residual[k] = views_[k].expectedReturn - applyView(views_[k], impliedReturns_.data());
+    }
+    systemCholesky_.solve(residual.data(), residual.data());
+    for (Size k = 0; k < K; ++k) {
+        MatrixOperations::axpy(tau * residual[k], sigmaP_[k], posteriorReturns_.data(), n);
+    }
+}
+
+double BlackLitterman::applyView(const View& view, const Real* x) const {
+    double total = 0.0;
+    for (const auto& entry : view.assets) {
+        total += entry.second * x[entry.first];
+    }
+    return total;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "SymmetricMatrix.hpp"
+
+using namespace QuantLib;
+
+// Black-Litterman expected returns. The prior is the equilibrium return
+// implied by benchmark weights, pi = delta Sigma w_b. K views P mu = Q + e,
+// e ~ N(0, Omega), then give the posterior
+//
+//   mu     = pi + tau Sigma P' A^-1 (Q - P pi),   A = tau P Sigma P' + Omega
+//   Sigma* = (1 + tau) Sigma - tau^2 Sigma P' A^-1 P Sigma
+//
+// Sigma is factored once, at construction. A view change only rebuilds
+// U = Sigma P' from the assets each view references, plus the K x K
+// system. Views usually name one or two assets, so repricing costs
+// O(N K s + K^3) (s = assets per view) instead of an O(N^3) refactor.
+// Solves with Sigma* use the Woodbury identity on the cached factor:
+//
+//   Sigma*^-1 b = Sigma^-1 b / (1 + tau) + P' H^-1 P b / (1 + tau)^2,
+//   H = A / tau^2 - P Sigma P' / (1 + tau)
+//
+// That is one O(N^2) triangular solve pair plus O(K^2) work.
+class BlackLitterman {
+public:
+    struct BlackLittermanParameters {
+        double riskAversion{2.5};       // delta in pi = delta Sigma w_b
+        double tau{0.05};               // prior uncertainty scale
+
+        BlackLittermanParameters() = default;
+    };
+
+    // One row of P with its Q entry. A variance <= 0 takes the
+    // He-Litterman default tau p' Sigma p for its Omega diagonal.
+    struct View {
+        std::vector<std::pair<Size, double>> assets;    // (asset, coefficient)
+        double expectedReturn{0.0};
+        double variance{0.0};
+
+        View() = default;
+    };
+
+    BlackLitterman(const SymmetricMatrix& covariance, const std::vector<double>& benchmarkWeights);
+    BlackLitterman(const SymmetricMatrix& covariance, const std::vector<double>& benchmarkWeights,
+                   const BlackLittermanParameters& parameters);
+
+    static View absoluteView(Size asset, double expectedReturn, double variance = 0.0);
+    static View relativeView(Size longAsset, Size shortAsset, double outperformance,
+                             double variance = 0.0);
+
+    // Replaces the views. The dense form takes P (K x N), Q (K) and Omega
+    // (K x K); an empty Omega uses the He-Litterman diagonal.
+    void setViews(const std::vector<View>& views);
+    void setViews(const Matrix& P, const std::vector<double>& Q, const Matrix& omega);
+    void addView(const View& view);
+    void clearViews();
+    size_t numViews() const { return views_.size(); }
+
+    // New benchmark weights reprice the prior in O(N^2) without refactoring
+    void setBenchmarkWeights(const std::vector<double>& benchmarkWeights);
+
+    const std::vector<double>& impliedReturns() const { return impliedReturns_; }
+    const std::vector<double>& posteriorReturns();
+
+    // Sigma*^-1 b on the cached factor; x and b may alias
+    void solvePosterior(const Real* b, Real* x);
+    SymmetricMatrix posteriorCovariance();
+
+    // Unconstrained optimum Sigma*^-1 mu / delta
+    std::vector<double> optimalWeights();
+
+private:
+    BlackLittermanParameters parameters_;
+    SymmetricMatrix covariance_;
+    PackedCholesky cholesky_;
+    std::vector<double> impliedReturns_;
+
+    std::vector<View> views_;
+    Matrix omega_;                      // explicit K x K Omega; empty = diagonal from views_
+    bool stale_{true};
+
+    // Derived from the views, rebuilt by refresh()
+    Matrix sigmaP_;                     // K x N, row k = Sigma p_k
+    PackedCholesky systemCholesky_;     // A
+    PackedCholesky woodburyCholesky_;   // H
+    std::vector<double> posteriorReturns_;
+
+    // Private helper methods
+    void refresh();
+    double applyView(const View& view, const Real* x) const;    // p_k' x
+};
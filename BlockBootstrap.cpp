@@ -0,0 +1,223 @@
+#include "BlockBootstrap.hpp"
+#include "LRUCache.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+void BlockBootstrap::Workspace::resize(size_t lanes) {
+    state.resize(lanes);
+    position.resize(lanes);
+    for (auto* column : {&sum, &sumSquares, &downsideSquares, &downsideCount,
+                         &activeSum, &activeSquares, &value, &peak, &drawdown}) {
+        column->resize(lanes);
+    }
+}
+
+BlockBootstrap::BlockBootstrap()
+    : BlockBootstrap(BootstrapParameters()) {}
+
+BlockBootstrap::BlockBootstrap(const BootstrapParameters& parameters)
+    : parameters_(parameters)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads))
+    , workspaces_(pool_->size()) {
+    for (auto& workspace : workspaces_) {
+        workspace.resize(LANES);
+    }
+}
+
+BlockBootstrap::MetricIntervals BlockBootstrap::run(const std::vector<double>& portfolioReturns,
+                                                    const std::vector<double>& benchmarkReturns) {
+    try {
+        PROFILE_SCOPE("block_bootstrap");
+        const size_t n = portfolioReturns.size();
+        if (benchmarkReturns.size() != n) {
+            throw std::runtime_error("portfolio and benchmark series differ in length");
+        }
+        if (n < 3 || n > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("series length " + std::to_string(n) + " is out of range");
+        }
+        if (parameters_.numReplicates < 1 || !(parameters_.confidenceLevel > 0.0 && parameters_.confidenceLevel < 1.0)) {
+            throw std::runtime_error("invalid replicate count or confidence level");
+        }
+
+        double blockLength = parameters_.expectedBlockLength > 0.0
+            ? parameters_.expectedBlockLength
+            : std::cbrt(static_cast<double>(n));
+        blockLength = std::max(1.0, std::min(blockLength, static_cast<double>(n)));
+
+        // Sums are accumulated around the sample means to avoid cancellation
+        std::vector<double> active(n);
+        Moments shift{0.0, 0.0};
+        for (size_t t = 0; t < n; ++t) {
+            active[t] = portfolioReturns[t] - benchmarkReturns[t];
+            shift.mean += portfolioReturns[t];
+            shift.activeMean += active[t];
+        }
+        shift.mean /= n;
+        shift.activeMean /= n;
+
+        // Point estimates through the same kernel
+        double estimates[METRIC_COUNT];
+        {
+            Workspace single;
+            single.resize(1);
+            std::vector<double> one[METRIC_COUNT];
+            for (auto& metric : one) metric.resize(1);
+            runBatch(portfolioReturns, active, shift, 0.0, true, 0, 1, single, one);
+            for (int m = 0; m < METRIC_COUNT; ++m) estimates[m] = one[m][0];
+        }
+
+        // Replicates, LANES at a time
+        const size_t replicates = parameters_.numReplicates;
+        std::vector<double> metrics[METRIC_COUNT];
+        for (auto& metric : metrics) metric.resize(replicates);
+        size_t batches = (replicates + LANES - 1) / LANES;
+        pool_->parallelFor(batches, [&](size_t batch, size_t worker) {
+            size_t first = batch * LANES;
+            runBatch(portfolioReturns, active, shift, 1.0 / blockLength, false,
+                     first, std::min(LANES, replicates - first), workspaces_[worker], metrics);
+        });
+
+        MetricIntervals result;
+        result.replicates = parameters_.numReplicates;
+        result.blockLength = blockLength;
+        result.sharpeRatio = summarize(metrics[SHARPE], estimates[SHARPE]);
+        result.sortino = summarize(metrics[SORTINO], estimates[SORTINO]);
+        result.informationRatio = summarize(metrics[INFORMATION_RATIO], estimates[INFORMATION_RATIO]);
+        result.maxDrawdown = summarize(metrics[MAX_DRAWDOWN], estimates[MAX_DRAWDOWN]);
+        return result;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in BlockBootstrap::run: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+void BlockBootstrap::runBatch(const std::vector<double>& portfolio, const std::vector<double>& active,
+                              const Moments& shift, double jumpProbability, bool fromStart,
+                              size_t firstReplicate, size_t lanes,
+                              Workspace& workspace, std::vector<double>* metrics) const {
+    const size_t n = portfolio.size();
+    const uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;
+    // A new block starts when the top 32 bits of the draw fall below this
+    const uint64_t jumpThreshold = static_cast<uint64_t>(jumpProbability * 4294967296.0);
+    const double target = parameters_.targetReturn;
+
+    for (size_t r = 0; r < lanes; ++r) {
+        workspace.state[r] = MemoHash::combine(parameters_.seed, firstReplicate + r);
+    }
+    std::fill_n(workspace.sum.begin(), lanes, 0.0);
+    std::fill_n(workspace.sumSquares.begin(), lanes, 0.0);
+    std::fill_n(workspace.downsideSquares.begin(), lanes, 0.0);
+    std::fill_n(workspace.downsideCount.begin(), lanes, 0.0);
+    std::fill_n(workspace.activeSum.begin(), lanes, 0.0);
+    std::fill_n(workspace.activeSquares.begin(), lanes, 0.0);
+    std::fill_n(workspace.value.begin(), lanes, 1.0);
+    std::fill_n(workspace.peak.begin(), lanes, 1.0);
+    std::fill_n(workspace.drawdown.begin(), lanes, 0.0);
+
+    uint64_t* state = workspace.state.data();
+    uint32_t* position = workspace.position.data();
+    double* sum = workspace.sum.data();
+    double* sumSquares = workspace.sumSquares.data();
+    double* downsideSquares = workspace.downsideSquares.data();
+    double* downsideCount = workspace.downsideCount.data();
+    double* activeSum = workspace.activeSum.data();
+    double* activeSquares = workspace.activeSquares.data();
+    double* value = workspace.value.data();
+    double* peak = workspace.peak.data();
+    double* drawdown = workspace.drawdown.data();
+
+    for (size_t t = 0; t < n; ++t) {
+        // Next index per lane: continue the block or jump to a uniform start
+        for (size_t r = 0; r < lanes; ++r) {
+            state[r] += GOLDEN;
+            uint64_t z = MemoHash::mix(state[r]);
+            uint32_t start = static_cast<uint32_t>(((z & 0xffffffffULL) * n) >> 32);
+            uint32_t next = position[r] + 1 == n ? 0 : position[r] + 1;
+            bool jump = (z >> 32) < jumpThreshold;
+            position[r] = t == 0 ? (fromStart ? 0 : start) : (jump ? start : next);
+        }
+
+        // Fused update of every statistic, contiguous across lanes
+        for (size_t r = 0; r < lanes; ++r) {
+            double x = portfolio[position[r]];
+            double a = active[position[r]] - shift.activeMean;
+            double c = x - shift.mean;
+            double below = x < target ? 1.0 : 0.0;
+            double d = (target - x) * below;
+
+            sum[r] += c;
+            sumSquares[r] += c * c;
+            downsideSquares[r] += d * d;
+            downsideCount[r] += below;
+            activeSum[r] += a;
+            activeSquares[r] += a * a;
+            value[r] *= 1.0 + x;
+            peak[r] = std::max(peak[r], value[r]);
+            drawdown[r] = std::max(drawdown[r], 1.0 - value[r] / peak[r]);
+        }
+    }
+
+    double out[METRIC_COUNT];
+    for (size_t r = 0; r < lanes; ++r) {
+        finalize(workspace, r, n, shift, out);
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            metrics[m][firstReplicate + r] = out[m];
+        }
+    }
+}
+
+void BlockBootstrap::finalize(const Workspace& workspace, size_t lane, size_t n, const Moments& shift,
+                              double* out) const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double meanOffset = workspace.sum[lane] / n;
+    double mean = shift.mean + meanOffset;
+    double variance = (workspace.sumSquares[lane] - n * meanOffset * meanOffset) / (n - 1);
+    double activeOffset = workspace.activeSum[lane] / n;
+    double activeMean = shift.activeMean + activeOffset;
+    double activeVariance = (workspace.activeSquares[lane] - n * activeOffset * activeOffset) / (n - 1);
+    double downside = workspace.downsideCount[lane] > 0.0
+        ? std::sqrt(workspace.downsideSquares[lane] / workspace.downsideCount[lane])
+        : 0.0;
+
+    out[SHARPE] = variance > 0.0 ? (mean - parameters_.riskFreeRate.value_or(0.0)) / std::sqrt(variance) : nan;
+    out[SORTINO] = downside > 0.0 ? (mean - parameters_.targetReturn) / downside : nan;
+    out[INFORMATION_RATIO] = activeVariance > 0.0 ? activeMean / std::sqrt(activeVariance) : nan;
+    out[MAX_DRAWDOWN] = workspace.drawdown[lane];
+}
+
+BlockBootstrap::Interval BlockBootstrap::summarize(std::vector<double>& replicates, double estimate) const {
+    // Degenerate replicates (e.g. no below-target day) carry no information
+    replicates.erase(std::remove_if(replicates.begin(), replicates.end(),
+                                    [](double v) { return !std::isfinite(v); }),
+                     replicates.end());
+
+    Interval interval;
+    interval.estimate = estimate;
+    if (replicates.empty()) {
+        interval.lower = interval.upper = interval.standardError = std::numeric_limits<double>::quiet_NaN();
+        return interval;
+    }
+
+    double mean = 0.0;
+    for (double v : replicates) mean += v;
+    mean /= replicates.size();
+    double variance = 0.0;
+    for (double v : replicates) variance += (v - mean) * (v - mean);
+    interval.standardError = replicates.size() > 1 ? std::sqrt(variance / (replicates.size() - 1)) : 0.0;
+
+    // Percentile interval from order statistics
+    double alpha = (1.0 - parameters_.confidenceLevel) / 2.0;
+    size_t last = replicates.size() - 1;
+    size_t lo = static_cast<size_t>(std::floor(alpha * last));
+    size_t hi = static_cast<size_t>(std::ceil((1.0 - alpha) * last));
+    std::nth_element(replicates.begin(), replicates.begin() + lo, replicates.end());
+    interval.lower = replicates[lo];
+    std::nth_element(replicates.begin() + lo, replicates.begin() + hi, replicates.end());
+    interval.upper = replicates[hi];
+    return interval;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "WorkStealingPool.hpp"
+
+// Stationary block bootstrap (Politis-Romano) confidence intervals for
+// Sharpe, Sortino, information ratio and maximum drawdown of a daily
+// portfolio return series. Each replicate resamples the portfolio and
+// benchmark returns together, using blocks of geometric length with mean
+// expectedBlockLength that wrap around the end of the series. This keeps
+// the serial dependence that an iid bootstrap would destroy.
+//
+// Replicates are processed in batches of LANES with replicate-major state:
+// each time step updates one contiguous array per statistic across the
+// batch, and all four metrics come out of that single fused pass. Batches
+// run on a work-stealing pool. Replicate r is seeded from (seed, r) alone,
+// so the intervals do not depend on the thread count.
+//
+// Metrics follow RiskMetrics (daily, not annualized): Sharpe is
+// (mean - rf) / sd, Sortino is (mean - target) / downside deviation over the
+// below-target days, IR is mean / sd of the active return, and max drawdown
+// is the largest compounded peak-to-trough loss, as a positive fraction.
+class BlockBootstrap {
+public:
+    struct BootstrapParameters {
+        int numReplicates{5000};
+        double expectedBlockLength{0.0};    // 0 = T^(1/3)
+        double confidenceLevel{0.95};       // two-sided percentile interval
+        std::optional<double> riskFreeRate; // daily; unset = 0 here, the caller's rate in weight.cpp
+        double targetReturn{0.0};           // Sortino threshold, daily
+        uint64_t seed{20240101};
+        size_t numThreads{0};               // 0 = hardware concurrency
+
+        BootstrapParameters() = default;
+    };
+
+    struct Interval {
+        double estimate{0.0};       // on the original series
+        double lower{0.0};
+        double upper{0.0};
+        double standardError{0.0};  // sd across replicates
+    };
+
+    struct MetricIntervals {
+        Interval sharpeRatio;
+        Interval sortino;
+        Interval informationRatio;
+        Interval maxDrawdown;
+        int replicates{0};
+        double blockLength{0.0};
+    };
+
+    BlockBootstrap();
+    explicit BlockBootstrap(const BootstrapParameters& parameters);
+
+    // Both series in chronological order and of equal length
+    MetricIntervals run(const std::vector<double>& portfolioReturns,
+                        const std::vector<double>& benchmarkReturns);
+
+private:
+    static const size_t LANES = 64;
+
+    enum Metric { SHARPE, SORTINO, INFORMATION_RATIO, MAX_DRAWDOWN, METRIC_COUNT };
+
+    // Per-lane running sums, one array per statistic
+    struct Workspace {
+        std::vector<uint64_t> state;
+        std::vector<uint32_t> position;
+        std::vector<double> sum, sumSquares;
+        std::vector<double> downsideSquares, downsideCount;
+        std::vector<double> activeSum, activeSquares;
+        std::vector<double> value, peak, drawdown;
+
+        void resize(size_t lanes);
+    };
+
+    struct Moments {
+        double mean;                // of the original series, used as shift
+        double activeMean;
+    };
+
+    BootstrapParameters parameters_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::vector<Workspace> workspaces_;
+
+    // Private helper methods
+    // jumpProbability = 0 with fromStart replays the original series
+    void runBatch(const std::vector<double>& portfolio, const std::vector<double>& active,
+                  const Moments& shift, double jumpProbability, bool fromStart,
+                  size_t firstReplicate, size_t lanes,
+                  Workspace& workspace, std::vector<double>* metrics) const;
+    void finalize(const Workspace& workspace, size_t lane, size_t n, const Moments& shift,
+                  double* out) const;
+    Interval summarize(std::vector<double>& replicates, double estimate) const;
+};
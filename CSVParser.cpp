@@ -91,9 +91,11 @@ void Parser::parseContent(void)
 		//end
 		row->push(it->substr(tokenStart, it->length() - tokenStart));
 
-		// if value(s) missing
-		if (row->size() != _header.size())
+		// missing trailing value(s) are kept as empty fields
+		if (row->size() > _header.size())
 			throw Error("corrupted data !");
+		while (row->size() < _header.size())
+			row->push("");
 		_content.push_back(row);
 	}
 }
@@ -0,0 +1,347 @@
+#include "CVaROptimizer.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+CVaROptimizer::CVaROptimizer()
+    : CVaROptimizer(CVaRParameters()) {}
+
+CVaROptimizer::CVaROptimizer(const CVaRParameters& parameters)
+    : parameters_(parameters)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads)) {}
+
+CVaROptimizer::Result CVaROptimizer::minimize(const Matrix& scenarios) {
+    try {
+        PROFILE_SCOPE("cvar_optimizer");
+        prepare(scenarios);
+        Size n = scenarios.columns();
+        return solve(std::vector<double>(n, 1.0 / n));
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in CVaROptimizer::minimize: " + std::string(e.what()));
+    }
+}
+
+CVaROptimizer::Result CVaROptimizer::minimize(const Matrix& scenarios, double targetReturn) {
+    try {
+        PROFILE_SCOPE("cvar_optimizer");
+        prepare(scenarios);
+        Size n = scenarios.columns();
+
+        // Highest mean return the box allows: fill the best assets first
+        std::vector<Size> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](Size a, Size b) { return means_[a] > means_[b]; });
+        double remaining = 1.0 - n * parameters_.minWeight;
+        double best = 0.0;
+        for (Size j : order) {
+            double add = std::min(remaining, parameters_.maxWeight - parameters_.minWeight);
+            best += means_[j] * (parameters_.minWeight + add);
+            remaining -= add;
+        }
+        if (targetReturn > best + 1e-15) {
+            throw std::runtime_error("target return exceeds the best attainable mean return");
+        }
+
+        // The return floor becomes part of the feasible set
+        hasTarget_ = true;
+        targetReturn_ = targetReturn;
+        Result result = solve(std::vector<double>(n, 1.0 / n));
+        hasTarget_ = false;
+        return result;
+    }
+    catch (const std::exception& e) {
+        hasTarget_ = false;
+        throw std::runtime_error("Error in CVaROptimizer::minimize: " + std::string(e.what()));
+    }
+}
+
+CVaROptimizer::Result CVaROptimizer::evaluate(const Matrix& scenarios, const std::vector<double>& weights) {
+    prepare(scenarios);
+    if (weights.size() != scenarios.columns()) {
+        throw std::runtime_error("CVaROptimizer: weights do not match scenario columns");
+    }
+    Result result;
+    result.weights = weights;
+    result.converged = true;
+    finish(result);
+    return result;
+}
+
+// Private helper methods
+void CVaROptimizer::prepare(const Matrix& scenarios) {
+    const Size S = scenarios.rows();
+    const Size n = scenarios.columns();
+    const double alpha = parameters_.confidenceLevel;
+    if (S == 0 || n == 0) {
+        throw std::runtime_error("empty scenario matrix");
+    }
+    if (!(alpha > 0.0 && alpha < 1.0)) {
+        throw std::runtime_error("confidence level must be in (0, 1)");
+    }
+    if (parameters_.minWeight > parameters_.maxWeight ||
+        n * parameters_.minWeight > 1.0 + 1e-12 || n * parameters_.maxWeight < 1.0 - 1e-12) {
+        throw std::runtime_error("weight bounds do not admit a fully invested portfolio");
+    }
+
+    scenarios_ = &scenarios;
+    tailSize_ = std::max(1.0, (1.0 - alpha) * S);
+
+    size_t blocks = (S + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    partials_.assign(blocks * n, 0.0);
+    pool_->parallelFor(blocks, [&](size_t b, size_t) {
+        double* partial = partials_.data() + b * n;
+        Size last = std::min(S, (b + 1) * BLOCK_ROWS);
+        for (Size s = b * BLOCK_ROWS; s < last; ++s) {
+            MatrixOperations::axpy(1.0, scenarios[s], partial, n);
+        }
+    });
+    means_.assign(n, 0.0);
+    for (size_t b = 0; b < blocks; ++b) {
+        MatrixOperations::axpy(1.0 / S, partials_.data() + b * n, means_.data(), n);
+    }
+}
+
+CVaROptimizer::Result CVaROptimizer::solve(std::vector<double> start) {
+    const Matrix& R = *scenarios_;
+    const Size S = R.rows();
+    const Size n = R.columns();
+
+    // Smoothing bias is at most mu / (2k); each stage warm-starts the next
+    const double finalMu = 2.0 * tailSize_ * parameters_.tolerance;
+    const double stages[] = {1000.0, 100.0, 10.0, 1.0};
+
+    double frobenius = std::inner_product(R.begin(), R.end(), R.begin(), 0.0);
+
+    std::vector<double> w = start, wPrev(n), y(n), z(n), gradient(n);
+    std::vector<double> lossW(S), lossPrev(S), lossY(S), lossZ(S);
+    std::vector<double> q(S), qTrial(S);
+    project(w.data());
+    losses(w.data(), lossW.data());
+
+    Result result;
+    for (double stage : stages) {
+        const double mu = finalMu * stage;
+        double lipschitz = 1e-6 * frobenius / mu;
+        double t = 1.0, tPrev = 1.0;
+        wPrev = w;
+        lossPrev = lossW;
+        double valueW = smoothedValue(lossW.data(), mu, qTrial);
+        result.converged = false;
+
+        for (int iteration = 0; iteration < parameters_.maxIterations; ++iteration) {
+            ++result.iterations;
+            double beta = (tPrev - 1.0) / t;
+            for (Size j = 0; j < n; ++j) y[j] = w[j] + beta * (w[j] - wPrev[j]);
+            for (Size s = 0; s < S; ++s) lossY[s] = lossW[s] + beta * (lossW[s] - lossPrev[s]);
+
+            double valueY = smoothedValue(lossY.data(), mu, q);
+            tailGradient(q, gradient.data());
+
+            // Backtracking on the local Lipschitz estimate
+            double valueZ = 0.0;
+            for (;;) {
+                for (Size j = 0; j < n; ++j) z[j] = y[j] - gradient[j] / lipschitz;
+                project(z.data());
+                losses(z.data(), lossZ.data());
+                valueZ = smoothedValue(lossZ.data(), mu, qTrial);
+
+                double linear = 0.0, distance = 0.0;
+                for (Size j = 0; j < n; ++j) {
+                    double d = z[j] - y[j];
+                    linear += gradient[j] * d;
+                    distance += d * d;
+                }
+                if (valueZ <= valueY + linear + 0.5 * lipschitz * distance + 1e-15 * std::fabs(valueY)) break;
+                lipschitz *= 2.0;
+            }
+
+            // Adaptive restart: drop the momentum when the objective rises
+            if (valueZ > valueW && beta > 0.0) {
+                t = tPrev = 1.0;
+                wPrev = w;
+                lossPrev = lossW;
+                continue;
+            }
+
+            double step = 0.0;
+            for (Size j = 0; j < n; ++j) step = std::max(step, std::fabs(z[j] - w[j]));
+            double decrease = valueW - valueZ;
+            wPrev.swap(w);
+            w.swap(z);
+            lossPrev.swap(lossW);
+            lossW.swap(lossZ);
+            valueW = valueZ;
+            tPrev = t;
+            t = 0.5 * (1.0 + std::sqrt(1.0 + 4.0 * t * t));
+            lipschitz *= 0.9;
+
+            // Stalled well below the smoothing accuracy
+            if (step < 1e-6 && decrease < 1e-2 * parameters_.tolerance) {
+                result.converged = true;
+                break;
+            }
+        }
+    }
+
+    result.weights = w;
+    finish(result);
+    return result;
+}
+
+void CVaROptimizer::losses(const double* weights, double* out) const {
+    const Matrix& R = *scenarios_;
+    const Size S = R.rows();
+    const Size n = R.columns();
+    size_t blocks = (S + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    pool_->parallelFor(blocks, [&](size_t b, size_t) {
+        Size last = std::min(S, (b + 1) * BLOCK_ROWS);
+        for (Size s = b * BLOCK_ROWS; s < last; ++s) {
+            out[s] = -MatrixOperations::dot(R[s], weights, n);
+        }
+    });
+}
+
+double CVaROptimizer::smoothedValue(const double* losses, double mu, std::vector<double>& q) const {
+    // q = clamp(z - tau, 0, 1/k) with z = u + L / mu and tau set so that
+    // sum q = 1. Rows below the bracket stay at 0 and rows above it at 1/k,
+    // so they drop out of the bisection and it narrows to the tail.
+    const Size S = scenarios_->rows();
+    const double uniform = 1.0 / S;
+    const double cap = 1.0 / tailSize_;
+    for (Size s = 0; s < S; ++s) {
+        q[s] = uniform + losses[s] / mu;
+    }
+    double lo = *std::min_element(q.begin(), q.end()) - cap;
+    double hi = *std::max_element(q.begin(), q.end());
+
+    std::vector<double> candidates(q.begin(), q.end());
+    double capped = 0.0;
+    for (int k = 0; k < 200 && hi - lo > 1e-14 * std::max(1.0, std::fabs(hi)); ++k) {
+        if (k % 4 == 3) {
+            size_t kept = 0;
+            double sum = 0.0;
+            for (double z : candidates) {
+                if (z - cap >= hi) {
+                    capped += cap;
+                } else if (z > lo) {
+                    candidates[kept++] = z;
+                    sum += z;
+                }
+            }
+            candidates.resize(kept);
+
+            // Exact once every remaining row is strictly inside (0, 1/k)
+            double tau = kept ? (sum + capped - 1.0) / kept : 0.0;
+            bool linear = kept > 0;
+            for (size_t i = 0; i < kept && linear; ++i) {
+                linear = candidates[i] - cap < tau && candidates[i] > tau;
+            }
+            if (linear) {
+                lo = hi = tau;
+                break;
+            }
+        }
+        double tau = 0.5 * (lo + hi);
+        double total = capped;
+        for (double z : candidates) {
+            total += std::min(cap, std::max(0.0, z - tau));
+        }
+        (total > 1.0 ? lo : hi) = tau;
+    }
+
+    double tau = 0.5 * (lo + hi);
+    double value = 0.0, proximity = 0.0;
+    for (Size s = 0; s < S; ++s) {
+        q[s] = std::min(cap, std::max(0.0, q[s] - tau));
+        value += q[s] * losses[s];
+        proximity += (q[s] - uniform) * (q[s] - uniform);
+    }
+    return value - 0.5 * mu * proximity;
+}
+
+void CVaROptimizer::tailGradient(const std::vector<double>& q, double* gradient) {
+    // -R'q over the rows in the tail
+    const Matrix& R = *scenarios_;
+    const Size S = R.rows();
+    const Size n = R.columns();
+    size_t blocks = (S + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    pool_->parallelFor(blocks, [&](size_t b, size_t) {
+        double* partial = partials_.data() + b * n;
+        std::fill(partial, partial + n, 0.0);
+        Size last = std::min(S, (b + 1) * BLOCK_ROWS);
+        for (Size s = b * BLOCK_ROWS; s < last; ++s) {
+            if (q[s] > 0.0) MatrixOperations::axpy(-q[s], R[s], partial, n);
+        }
+    });
+    std::fill(gradient, gradient + n, 0.0);
+    for (size_t b = 0; b < blocks; ++b) {
+        MatrixOperations::axpy(1.0, partials_.data() + b * n, gradient, n);
+    }
+}
+
+void CVaROptimizer::project(double* weights) const {
+    // w = clamp(v - theta + nu m, min, max): theta sets sum w = 1 and
+    // nu >= 0 the smallest shift along m that meets the return floor
+    const Size n = scenarios_->columns();
+    const double low = parameters_.minWeight, high = parameters_.maxWeight;
+    std::vector<double> v(weights, weights + n);
+
+    auto budget = [&](double nu) {
+        double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+        for (Size j = 0; j < n; ++j) {
+            double shifted = v[j] + nu * means_[j];
+            lo = std::min(lo, shifted - high);
+            hi = std::max(hi, shifted - low);
+        }
+        for (int k = 0; k < 100 && hi - lo > 1e-15; ++k) {
+            double theta = 0.5 * (lo + hi);
+            double total = 0.0;
+            for (Size j = 0; j < n; ++j) {
+                total += std::min(high, std::max(low, v[j] + nu * means_[j] - theta));
+            }
+            (total > 1.0 ? lo : hi) = theta;
+        }
+        double theta = 0.5 * (lo + hi);
+        for (Size j = 0; j < n; ++j) {
+            weights[j] = std::min(high, std::max(low, v[j] + nu * means_[j] - theta));
+        }
+        return MatrixOperations::dot(means_.data(), weights, n);
+    };
+
+    if (budget(0.0) >= targetReturn_ || !hasTarget_) return;
+
+    double lower = 0.0, upper = 1.0;
+    while (budget(upper) < targetReturn_ && upper < 1e300) upper *= 2.0;
+    for (int k = 0; k < 100 && upper - lower > 1e-12 * upper; ++k) {
+        double middle = 0.5 * (lower + upper);
+        (budget(middle) < targetReturn_ ? lower : upper) = middle;
+    }
+    budget(upper);
+}
+
+void CVaROptimizer::finish(Result& result) const {
+    // Exact Rockafellar-Uryasev value at zeta = VaR
+    const Size S = scenarios_->rows();
+    const Size n = scenarios_->columns();
+    std::vector<double> loss(S);
+    losses(result.weights.data(), loss.data());
+
+    std::vector<double> sorted = loss;
+    Size index = static_cast<Size>(std::ceil(tailSize_ - 1e-9)) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end(), std::greater<double>());
+    double zeta = sorted[index];
+    double excess = 0.0;
+    for (double l : loss) {
+        excess += std::max(0.0, l - zeta);
+    }
+
+    result.valueAtRisk = zeta;
+    result.conditionalValueAtRisk = zeta + excess / tailSize_;
+    result.expectedReturn = MatrixOperations::dot(means_.data(), result.weights.data(), n);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "WorkStealingPool.hpp"
+
+using namespace QuantLib;
+
+// Minimum-CVaR (expected shortfall) portfolios over a scenario matrix, in
+// the Rockafellar-Uryasev sense: S rows of asset returns (historical days,
+// simulated draws or stressed paths), the loss of row s is -r_s'w, and
+// CVaR is the mean loss over the worst (1 - alpha) S rows.
+//
+// CVaR is the support function max_q q'L of the capped simplex
+// {0 <= q <= 1/k, sum q = 1}, k = (1 - alpha) S. The solver smooths it with
+// a proximity term on q (Nesterov smoothing) and runs accelerated projected
+// gradient (FISTA with backtracking and adaptive restart) on w. The box,
+// budget and optional return floor are handled by a bisection projection.
+// The smoothing shrinks over a few warm-started stages until its bias is
+// below tolerance. The scenario
+// structure does most of the work:
+//  - the maximizing q is zero outside the loss tail, so the gradient R'q
+//    only touches about k rows;
+//  - losses are linear in w, so the extrapolated point's losses come from
+//    the last two iterates and each iteration needs one pass over R;
+//  - that pass, and the gradient, run over scenario blocks on a
+//    work-stealing pool, with partial sums reduced in block order so
+//    results do not depend on the thread count.
+class CVaROptimizer {
+public:
+    struct CVaRParameters {
+        double confidenceLevel{0.95};
+        double minWeight{0.0};          // per-asset box; 0 = long only
+        double maxWeight{1.0};
+        double tolerance{1e-6};         // smoothing bias bound, in loss units
+        int maxIterations{5000};        // per smoothing stage
+        size_t numThreads{0};           // 0 = hardware concurrency
+
+        CVaRParameters() = default;
+    };
+
+    struct Result {
+        std::vector<double> weights;
+        double conditionalValueAtRisk{0.0};     // positive loss
+        double valueAtRisk{0.0};
+        double expectedReturn{0.0};             // mean scenario return
+        int iterations{0};
+        bool converged{false};
+    };
+
+    CVaROptimizer();
+    explicit CVaROptimizer(const CVaRParameters& parameters);
+
+    // Minimum CVaR, fully invested within the weight box
+    Result minimize(const Matrix& scenarios);
+
+    // Minimum CVaR subject to a mean scenario return of at least
+    // targetReturn; the floor is enforced inside the projection
+    Result minimize(const Matrix& scenarios, double targetReturn);
+
+    // CVaR and VaR of fixed weights over the scenarios (exact, no smoothing)
+    Result evaluate(const Matrix& scenarios, const std::vector<double>& weights);
+
+private:
+    static const size_t BLOCK_ROWS = 2048;
+
+    CVaRParameters parameters_;
+    std::unique_ptr<WorkStealingPool> pool_;
+
+    // Per-problem state, sized by prepare()
+    const Matrix* scenarios_{nullptr};
+    double tailSize_{0.0};              // k = (1 - alpha) S
+    std::vector<double> means_;
+    std::vector<double> partials_;      // blocks x N gradient partial sums
+    bool hasTarget_{false};
+    double targetReturn_{0.0};
+
+    // Private helper methods
+    void prepare(const Matrix& scenarios);
+    Result solve(std::vector<double> start);
+    void losses(const double* weights, double* out) const;
+    double smoothedValue(const double* losses, double mu, std::vector<double>& q) const;
+    void tailGradient(const std::vector<double>& q, double* gradient);
+    void project(double* weights) const;
+    void finish(Result& result) const;
+};
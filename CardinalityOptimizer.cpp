@@ -0,0 +1,404 @@
+#include "CardinalityOptimizer.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+CardinalityOptimizer::CardinalityOptimizer()
+    : CardinalityOptimizer(CardinalityParameters()) {}
+
+CardinalityOptimizer::CardinalityOptimizer(const CardinalityParameters& parameters)
+    : parameters_(parameters)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads)) {}
+
+CardinalityOptimizer::CardinalityParameters CardinalityOptimizer::fromLimits(
+    const RiskConstraints::ConstraintLimits& limits) {
+
+    CardinalityParameters parameters;
+    parameters.minPositions = limits.minPositions;
+    parameters.maxPositions = limits.maxPositions;
+    parameters.maxWeight = limits.maxPositionSize;
+    parameters.maxSectorExposure = limits.maxSectorExposure;
+    if (limits.minTradeSize > 0.0) {
+        parameters.minWeight = 2.0 * limits.minTradeSize;
+    }
+    return parameters;
+}
+
+CardinalityOptimizer::Result CardinalityOptimizer::track(
+    const SymmetricMatrix& covariance,
+    const std::vector<double>& benchmarkWeights,
+    const std::map<int, std::string>& sectorMap) {
+
+    return optimize(covariance, std::vector<double>(), benchmarkWeights, sectorMap);
+}
+
+CardinalityOptimizer::Result CardinalityOptimizer::optimize(
+    const SymmetricMatrix& covariance,
+    const std::vector<double>& expectedReturns,
+    const std::vector<double>& benchmarkWeights,
+    const std::map<int, std::string>& sectorMap) {
+
+    try {
+        PROFILE_SCOPE("cardinality_optimizer");
+        prepare(covariance, expectedReturns, benchmarkWeights, sectorMap);
+
+        std::unique_ptr<State> state = seed();
+        grow(state);
+
+        int swaps = 0;
+        bool converged = false;
+        while (swaps < parameters_.maxSwapRounds) {
+            if (!improveBySwap(state)) {
+                converged = true;
+                break;
+            }
+            ++swaps;
+        }
+
+        Result result = finish(*state);
+        result.swaps = swaps;
+        result.converged = converged;
+        return result;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in CardinalityOptimizer::optimize: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+void CardinalityOptimizer::prepare(
+    const SymmetricMatrix& covariance,
+    const std::vector<double>& expectedReturns,
+    const std::vector<double>& benchmarkWeights,
+    const std::map<int, std::string>& sectorMap) {
+
+    const Size n = covariance.size();
+    if (n == 0) {
+        throw std::runtime_error("empty covariance");
+    }
+    if (!expectedReturns.empty() && expectedReturns.size() != n) {
+        throw std::runtime_error("expected returns do not match the covariance");
+    }
+    if (!benchmarkWeights.empty() && benchmarkWeights.size() != n) {
+        throw std::runtime_error("benchmark weights do not match the covariance");
+    }
+    if (!(parameters_.minWeight > 0.0) || parameters_.maxWeight < parameters_.minWeight) {
+        throw std::runtime_error("weight box must satisfy 0 < minWeight <= maxWeight");
+    }
+
+    covariance_ = &covariance;
+    expectedReturns_ = expectedReturns.empty() ? std::vector<double>(n, 0.0) : expectedReturns;
+    benchmark_ = benchmarkWeights.empty() ? std::vector<double>(n, 0.0) : benchmarkWeights;
+
+    // Sector names to dense ids
+    std::map<std::string, int> ids;
+    sectors_.assign(n, -1);
+    for (const auto& entry : sectorMap) {
+        if (entry.first < 0 || static_cast<Size>(entry.first) >= n) continue;
+        auto inserted = ids.emplace(entry.second, static_cast<int>(ids.size()));
+        sectors_[entry.first] = inserted.first->second;
+    }
+    numSectors_ = ids.size();
+
+    // Fewer than 1 / maxWeight names cannot hold the budget
+    size_t boxMinimum = static_cast<size_t>(std::ceil(1.0 / parameters_.maxWeight - 1e-12));
+    minHoldings_ = std::max(static_cast<size_t>(std::max(parameters_.minPositions, 1)), boxMinimum);
+    maxHoldings_ = std::min(static_cast<size_t>(std::max(parameters_.maxPositions, 0)), n);
+    if (minHoldings_ > maxHoldings_) {
+        throw std::runtime_error("position limits admit no portfolio of " + std::to_string(n) + " assets");
+    }
+    if (minHoldings_ * parameters_.minWeight > 1.0 + 1e-12) {
+        throw std::runtime_error("minWeight times minPositions exceeds the budget");
+    }
+
+    // Gradient gaps are compared against the typical gradient size
+    double diagonal = 0.0;
+    for (Size i = 0; i < n; ++i) {
+        diagonal += covariance(i, i);
+    }
+    double scale = 2.0 * parameters_.riskAversion * diagonal / n;
+    for (double mu : expectedReturns_) {
+        scale = std::max(scale, std::abs(mu));
+    }
+    gapTolerance_ = parameters_.tolerance * (scale > 0.0 ? scale : 1.0);
+}
+
+std::unique_ptr<CardinalityOptimizer::State> CardinalityOptimizer::seed() {
+    const Size n = covariance_->size();
+    const double floor = parameters_.minWeight;
+    const double cap = parameters_.maxSectorExposure;
+
+    // Gradient at w = 0 ranks names by how much they help the objective
+    std::vector<double> start(n);
+    MatrixOperations::symv(*covariance_, benchmark_.data(), start.data());
+    std::vector<double> score(n);
+    for (Size i = 0; i < n; ++i) {
+        score[i] = -2.0 * parameters_.riskAversion * start[i] - expectedReturns_[i];
+    }
+    std::vector<Size> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&score](Size a, Size b) { return score[a] < score[b]; });
+
+    // Take names in that order until the support can hold the budget
+    std::vector<Size> chosen;
+    std::vector<size_t> sectorCounts(numSectors_, 0);
+    double capacity = 0.0;
+    for (Size i : order) {
+        if (chosen.size() >= minHoldings_ && capacity >= 1.0 - 1e-12) break;
+        if (chosen.size() >= maxHoldings_) break;
+
+        int s = sectors_[i];
+        if (s >= 0) {
+            if ((sectorCounts[s] + 1) * floor > cap + 1e-12) continue;
+            double before = std::min(cap, sectorCounts[s] * parameters_.maxWeight);
+            ++sectorCounts[s];
+            capacity += std::min(cap, sectorCounts[s] * parameters_.maxWeight) - before;
+        }
+        else {
+            capacity += parameters_.maxWeight;
+        }
+        chosen.push_back(i);
+    }
+    if (chosen.size() < minHoldings_ || capacity < 1.0 - 1e-12) {
+        throw std::runtime_error("box and sector limits admit no fully invested portfolio");
+    }
+
+    // Everyone at the floor, then the rest in score order up to the caps
+    std::vector<double> weights(n, 0.0);
+    std::vector<double> sectorWeights(numSectors_, 0.0);
+    for (Size i : chosen) {
+        weights[i] = floor;
+        if (sectors_[i] >= 0) sectorWeights[sectors_[i]] += floor;
+    }
+    double remaining = 1.0 - chosen.size() * floor;
+    for (Size i : chosen) {
+        if (remaining <= 0.0) break;
+        int s = sectors_[i];
+        double room = parameters_.maxWeight - floor;
+        if (s >= 0) room = std::min(room, cap - sectorWeights[s]);
+        double add = std::max(0.0, std::min(room, remaining));
+        weights[i] += add;
+        if (s >= 0) sectorWeights[s] += add;
+        remaining -= add;
+    }
+
+    auto state = std::make_unique<State>(*covariance_, expectedReturns_);
+    state->held.assign(n, 0);
+    state->sectorWeights = sectorWeights;
+    for (Size i : chosen) {
+        state->held[i] = 1;
+        state->holdings.push_back(i);
+    }
+
+    Matrix active(n, 1);
+    for (Size i = 0; i < n; ++i) {
+        active[i][0] = weights[i] - benchmark_[i];
+    }
+    state->evaluator.reset(active, active);
+    return state;
+}
+
+void CardinalityOptimizer::grow(std::unique_ptr<State>& state) {
+    const Size n = covariance_->size();
+    const double floor = parameters_.minWeight;
+    solve(*state);
+
+    while (state->holdings.size() < maxHoldings_) {
+        // Donor: the held name with the largest gradient that can give a floor
+        Size donor = n;
+        double donorGradient = -std::numeric_limits<double>::infinity();
+        for (Size k : state->holdings) {
+            double g = gradient(*state, k);
+            if (weight(*state, k) >= 2.0 * floor && g > donorGradient) {
+                donor = k;
+                donorGradient = g;
+            }
+        }
+        if (donor == n) break;
+
+        // Entrant: the unheld name with the smallest gradient that fits
+        Size entrant = n;
+        double entrantGradient = std::numeric_limits<double>::infinity();
+        for (Size j = 0; j < n; ++j) {
+            if (state->held[j]) continue;
+            bool fits = sectors_[j] < 0 || sectors_[j] == sectors_[donor] || headroom(*state, j) >= floor;
+            double g = gradient(*state, j);
+            if (fits && g < entrantGradient) {
+                entrant = j;
+                entrantGradient = g;
+            }
+        }
+        if (entrant == n || entrantGradient >= donorGradient - gapTolerance_) break;
+
+        // Keep the name only if the re-solved support is better
+        auto previous = std::make_unique<State>(*state);
+        transfer(*state, donor, entrant, floor);
+        hold(*state, entrant);
+        solve(*state);
+        if (objective(*state) >= objective(*previous) - gapTolerance_ * floor) {
+            state = std::move(previous);
+            break;
+        }
+    }
+}
+
+bool CardinalityOptimizer::improveBySwap(std::unique_ptr<State>& state) {
+    const Size n = covariance_->size();
+    const double current = objective(*state);
+
+    // Price every exchange of a held name's whole weight into an unheld one
+    std::vector<Swap> swaps;
+    swaps.reserve(state->holdings.size() * (n - state->holdings.size()));
+    IncrementalEvaluator::Move move;
+    for (Size out : state->holdings) {
+        double amount = weight(*state, out);
+        for (Size in = 0; in < n; ++in) {
+            if (state->held[in]) continue;
+            if (sectors_[in] >= 0 && sectors_[in] != sectors_[out] && headroom(*state, in) < amount) continue;
+
+            move.clear();
+            move.add(out, -amount);
+            move.add(in, amount);
+            IncrementalEvaluator::Evaluation candidate = state->evaluator.evaluateMove(move);
+            double change = parameters_.riskAversion * candidate.variance - candidate.expectedReturn - current;
+            swaps.push_back({out, in, change});
+        }
+    }
+    if (swaps.empty()) return false;
+
+    auto better = [](const Swap& a, const Swap& b) {
+        if (a.change != b.change) return a.change < b.change;
+        return a.out != b.out ? a.out < b.out : a.in < b.in;
+    };
+    size_t count = std::min(std::max<size_t>(parameters_.swapCandidates, 1), swaps.size());
+    std::partial_sort(swaps.begin(), swaps.begin() + count, swaps.end(), better);
+
+    // Re-solve the shortlisted supports side by side
+    std::vector<std::unique_ptr<State>> trials(count);
+    pool_->parallelFor(count, [&](size_t index, size_t) {
+        const Swap& swap = swaps[index];
+        auto trial = std::make_unique<State>(*state);
+        transfer(*trial, swap.out, swap.in, weight(*trial, swap.out));
+        release(*trial, swap.out);
+        hold(*trial, swap.in);
+        solve(*trial);
+        trials[index] = std::move(trial);
+    });
+
+    size_t best = 0;
+    for (size_t t = 1; t < count; ++t) {
+        if (objective(*trials[t]) < objective(*trials[best])) best = t;
+    }
+    if (objective(*trials[best]) >= current - gapTolerance_ * parameters_.minWeight) {
+        return false;
+    }
+    state = std::move(trials[best]);
+    return true;
+}
+
+void CardinalityOptimizer::solve(State& state) const {
+    const double floor = parameters_.minWeight;
+    const double gamma = parameters_.riskAversion;
+    const double infinity = std::numeric_limits<double>::infinity();
+    const Size k = state.holdings.size();
+    std::vector<double> g(k), w(k);
+
+    for (int it = 0; it < parameters_.maxIterations; ++it) {
+        for (Size a = 0; a < k; ++a) {
+            g[a] = gradient(state, state.holdings[a]);
+            w[a] = weight(state, state.holdings[a]);
+        }
+
+        // Most violating pair: donor with the largest gradient, receiver
+        // with the smallest, among pairs that can actually trade
+        double bestGap = 0.0, bestRoom = 0.0;
+        Size donor = k, receiver = k;
+        for (Size d = 0; d < k; ++d) {
+            if (w[d] - floor <= 1e-15) continue;
+            int donorSector = sectors_[state.holdings[d]];
+            for (Size r = 0; r < k; ++r) {
+                double gap = g[d] - g[r];
+                if (r == d || gap <= bestGap) continue;
+                Size asset = state.holdings[r];
+                double room = parameters_.maxWeight - w[r];
+                int s = sectors_[asset];
+                room = std::min(room, s >= 0 && s != donorSector ? headroom(state, asset) : infinity);
+                if (room <= 1e-15) continue;
+                bestGap = gap;
+                bestRoom = room;
+                donor = d;
+                receiver = r;
+            }
+        }
+        if (donor == k || bestGap <= gapTolerance_) break;
+
+        // Exact line search along e_receiver - e_donor, clipped to the box
+        Size i = state.holdings[receiver], j = state.holdings[donor];
+        double curvature = gamma * ((*covariance_)(i, i) + (*covariance_)(j, j) - 2.0 * (*covariance_)(i, j));
+        double step = curvature > 0.0 ? bestGap / (2.0 * curvature) : infinity;
+        step = std::min(step, std::min(w[donor] - floor, bestRoom));
+        transfer(state, j, i, step);
+        ++state.iterations;
+    }
+}
+
+void CardinalityOptimizer::transfer(State& state, Size from, Size to, double amount) const {
+    IncrementalEvaluator::Move move;
+    move.add(from, -amount);
+    move.add(to, amount);
+    state.evaluator.commitMove(move);
+    if (sectors_[from] >= 0) state.sectorWeights[sectors_[from]] -= amount;
+    if (sectors_[to] >= 0) state.sectorWeights[sectors_[to]] += amount;
+}
+
+void CardinalityOptimizer::hold(State& state, Size asset) const {
+    state.held[asset] = 1;
+    state.holdings.push_back(asset);
+}
+
+void CardinalityOptimizer::release(State& state, Size asset) const {
+    state.held[asset] = 0;
+    state.holdings.erase(std::find(state.holdings.begin(), state.holdings.end(), asset));
+}
+
+double CardinalityOptimizer::weight(const State& state, Size asset) const {
+    return state.evaluator.getWeights()[asset] + benchmark_[asset];
+}
+
+double CardinalityOptimizer::gradient(const State& state, Size asset) const {
+    return 2.0 * parameters_.riskAversion * state.evaluator.getSigmaW()[asset] - expectedReturns_[asset];
+}
+
+double CardinalityOptimizer::objective(const State& state) const {
+    // Active return only; mu'b is the same for every candidate
+    IncrementalEvaluator::Evaluation current = state.evaluator.current();
+    return parameters_.riskAversion * current.variance - current.expectedReturn;
+}
+
+double CardinalityOptimizer::headroom(const State& state, Size asset) const {
+    int s = sectors_[asset];
+    if (s < 0) return std::numeric_limits<double>::infinity();
+    return parameters_.maxSectorExposure - state.sectorWeights[s];
+}
+
+CardinalityOptimizer::Result CardinalityOptimizer::finish(const State& state) const {
+    const Size n = covariance_->size();
+    Result result;
+    result.weights.resize(n);
+    for (Size i = 0; i < n; ++i) {
+        result.weights[i] = state.held[i] ? weight(state, i) : 0.0;
+    }
+    result.holdings = state.holdings;
+    std::sort(result.holdings.begin(), result.holdings.end());
+
+    IncrementalEvaluator::Evaluation current = state.evaluator.current();
+    result.trackingError = current.risk;
+    result.expectedReturn = MatrixOperations::dot(expectedReturns_.data(), result.weights.data(), n);
+    result.objective = parameters_.riskAversion * current.variance - result.expectedReturn;
+    result.iterations = state.iterations;
+    return result;
+}
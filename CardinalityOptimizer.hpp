@@ -0,0 +1,139 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IncrementalEvaluator.hpp"
+#include "RiskConstraints.hpp"
+#include "SymmetricMatrix.hpp"
+#include "WorkStealingPool.hpp"
+
+using namespace QuantLib;
+
+// Long-only portfolios holding between minPositions and maxPositions names,
+// minimizing
+//
+//   riskAversion (w - b)'Sigma(w - b) - mu'w
+//
+// under a full budget, a per-name weight box and per-sector caps. With a
+// benchmark b and no mu this is a sparse index tracker; with b = 0 it is a
+// cardinality-limited mean-variance portfolio.
+//
+// Cardinality makes the problem combinatorial, so the search is a heuristic:
+//  - greedy: seed the support with the names whose gradient at w = 0 is
+//    most negative, then add one name at a time while the reduced cost says
+//    it helps;
+//  - on a fixed support, the weights are solved by pairwise coordinate
+//    descent: move weight from the name with the largest gradient to the
+//    one with the smallest, within box and sector headroom;
+//  - local swap: price every held/unheld exchange from the cached
+//    Sigma (w - b) in O(1) through IncrementalEvaluator, re-solve the most
+//    promising few on a work-stealing pool and keep the best, until no swap
+//    improves the objective.
+//
+// Each pairwise step and each committed swap updates Sigma (w - b) in O(N),
+// so nothing refactors or re-multiplies the covariance after the start.
+class CardinalityOptimizer {
+public:
+    struct CardinalityParameters {
+        int minPositions{10};
+        int maxPositions{50};
+        double minWeight{0.002};        // floor on every held name (> 0)
+        double maxWeight{0.2};
+        double maxSectorExposure{1.0};  // cap on the summed weight of a sector
+        double riskAversion{3.0};
+        double tolerance{1e-8};         // relative gradient gap for convergence
+        int maxIterations{20000};       // pairwise steps per support solve
+        int maxSwapRounds{100};
+        size_t swapCandidates{16};      // screened swaps re-solved per round
+        size_t numThreads{0};           // 0 = hardware concurrency
+
+        CardinalityParameters() = default;
+    };
+
+    struct Result {
+        std::vector<double> weights;
+        std::vector<Size> holdings;         // held names, ascending
+        double trackingError{0.0};          // sqrt((w - b)'Sigma(w - b)), per period
+        double expectedReturn{0.0};         // mu'w
+        double objective{0.0};
+        int swaps{0};
+        int iterations{0};                  // pairwise steps over the whole search
+        bool converged{false};              // no improving swap left
+    };
+
+    CardinalityOptimizer();
+    explicit CardinalityOptimizer(const CardinalityParameters& parameters);
+
+    // Position, sector and diversification limits from RiskConstraints.
+    // Held names stay at twice minTradeSize or more, so checkDiversification
+    // counts every one of them. minPositionSize is not used: shorts are
+    // never taken, even when the limits allow them.
+    static CardinalityParameters fromLimits(const RiskConstraints::ConstraintLimits& limits);
+
+    // Sparse tracker of benchmarkWeights
+    Result track(const SymmetricMatrix& covariance,
+                 const std::vector<double>& benchmarkWeights,
+                 const std::map<int, std::string>& sectorMap);
+
+    // General form; an empty expectedReturns or benchmarkWeights is zero.
+    // Assets missing from sectorMap have no sector cap.
+    Result optimize(const SymmetricMatrix& covariance,
+                    const std::vector<double>& expectedReturns,
+                    const std::vector<double>& benchmarkWeights,
+                    const std::map<int, std::string>& sectorMap);
+
+private:
+    // One point of the search. The evaluator holds the active weights
+    // w - b, so its variance is the tracking variance.
+    struct State {
+        IncrementalEvaluator evaluator;
+        std::vector<char> held;
+        std::vector<Size> holdings;
+        std::vector<double> sectorWeights;
+        int iterations{0};
+
+        State(const SymmetricMatrix& covariance, const std::vector<double>& expectedReturns)
+            : evaluator(covariance, expectedReturns) {}
+    };
+
+    struct Swap {
+        Size out;
+        Size in;
+        double change;
+    };
+
+    CardinalityParameters parameters_;
+    std::unique_ptr<WorkStealingPool> pool_;
+
+    // Per-problem data, set by prepare()
+    const SymmetricMatrix* covariance_{nullptr};
+    std::vector<double> expectedReturns_;
+    std::vector<double> benchmark_;
+    std::vector<int> sectors_;              // -1 = no cap
+    size_t numSectors_{0};
+    size_t minHoldings_{0};
+    size_t maxHoldings_{0};
+    double gapTolerance_{0.0};
+
+    // Private helper methods
+    void prepare(const SymmetricMatrix& covariance,
+                 const std::vector<double>& expectedReturns,
+                 const std::vector<double>& benchmarkWeights,
+                 const std::map<int, std::string>& sectorMap);
+    std::unique_ptr<State> seed();
+    void grow(std::unique_ptr<State>& state);
+    bool improveBySwap(std::unique_ptr<State>& state);
+    void solve(State& state) const;
+    void transfer(State& state, Size from, Size to, double amount) const;
+    void hold(State& state, Size asset) const;
+    void release(State& state, Size asset) const;
+
+    double weight(const State& state, Size asset) const;
+    double gradient(const State& state, Size asset) const;
+    double objective(const State& state) const;
+    double headroom(const State& state, Size asset) const;
+    Result finish(const State& state) const;
+};
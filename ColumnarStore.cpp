@@ -0,0 +1,400 @@
+#include "ColumnarStore.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    const char MAGIC[8] = {'P', 'F', 'C', 'O', 'L', 'U', 'M', 'N'};
+    const uint32_t VERSION = 1;
+    const size_t HEADER_BYTES = 64;
+    const size_t ALIGNMENT = 64;
+    const size_t NAME_BYTES = 48;
+    const size_t ENTRY_BYTES = 80;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t columnCount;
+        uint32_t dictionarySize;
+        uint32_t reserved;
+        uint64_t directoryOffset;
+        uint64_t dictionaryOffset;
+        uint64_t fileSize;
+        unsigned char padding[HEADER_BYTES - 48];
+    };
+    static_assert(sizeof(Header) == HEADER_BYTES, "header layout");
+
+    struct DirectoryEntry {
+        char name[NAME_BYTES];
+        uint8_t type;
+        uint8_t encoding;
+        uint16_t reserved16;
+        uint32_t reserved32;
+        uint64_t rows;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+    static_assert(sizeof(DirectoryEntry) == ENTRY_BYTES, "directory layout");
+
+    void pad(std::string& out, size_t alignment) {
+        out.append((alignment - out.size() % alignment) % alignment, '\0');
+    }
+
+    void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    uint64_t getVarint(const unsigned char*& p, const unsigned char* end) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) throw std::runtime_error("Truncated varint in column data");
+            unsigned char byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Malformed varint in column data");
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Element i of a plain block as a 64-bit pattern; signed types are
+    // sign-extended so that deltas stay small across zero
+    uint64_t load(const char* data, size_t i, ColumnarStore::Type type) {
+        switch (type) {
+            case ColumnarStore::Type::Float64:
+            case ColumnarStore::Type::Int64: {
+                uint64_t v;
+                std::memcpy(&v, data + i * 8, 8);
+                return v;
+            }
+            case ColumnarStore::Type::Int32:
+            case ColumnarStore::Type::Date: {
+                int32_t v;
+                std::memcpy(&v, data + i * 4, 4);
+                return static_cast<uint64_t>(static_cast<int64_t>(v));
+            }
+            default: {
+                uint32_t v;
+                std::memcpy(&v, data + i * 4, 4);
+                return v;
+            }
+        }
+    }
+
+    void store(unsigned char* data, size_t i, uint64_t value, size_t width) {
+        if (width == 8) {
+            std::memcpy(data + i * 8, &value, 8);
+        } else {
+            uint32_t v = static_cast<uint32_t>(value);
+            std::memcpy(data + i * 4, &v, 4);
+        }
+    }
+
+    bool isFloating(ColumnarStore::Type type) {
+        return type == ColumnarStore::Type::Float64 || type == ColumnarStore::Type::Float32;
+    }
+}
+
+size_t ColumnarStore::typeWidth(Type type) {
+    switch (type) {
+        case Type::Float64:
+        case Type::Int64:
+            return 8;
+        case Type::Float32:
+        case Type::Int32:
+        case Type::Date:
+        case Type::AssetId:
+            return 4;
+    }
+    throw std::runtime_error("Unknown column type");
+}
+
+void ColumnarWriter::addFloat64(const std::string& name, const std::vector<double>& values) {
+    addColumn(name, Type::Float64, values.data(), values.size());
+}
+
+void ColumnarWriter::addFloat32(const std::string& name, const std::vector<float>& values) {
+    addColumn(name, Type::Float32, values.data(), values.size());
+}
+
+void ColumnarWriter::addInt32(const std::string& name, const std::vector<int32_t>& values) {
+    addColumn(name, Type::Int32, values.data(), values.size());
+}
+
+void ColumnarWriter::addInt64(const std::string& name, const std::vector<int64_t>& values) {
+    addColumn(name, Type::Int64, values.data(), values.size());
+}
+
+void ColumnarWriter::addDates(const std::string& name, const std::vector<int32_t>& days) {
+    addColumn(name, Type::Date, days.data(), days.size());
+}
+
+void ColumnarWriter::addAssetIds(const std::string& name, const std::vector<uint32_t>& ids) {
+    for (uint32_t id : ids) {
+        if (id >= assets_.size()) {
+            throw std::runtime_error("Asset id " + std::to_string(id) + " in column " + name +
+                                     " is outside the asset dictionary");
+        }
+    }
+    addColumn(name, Type::AssetId, ids.data(), ids.size());
+}
+
+void ColumnarWriter::serialize(TextBuffer& out) const {
+    std::string& file = out.bytes();
+    size_t base = file.size();
+    file.append(HEADER_BYTES, '\0');
+
+    // Column blocks
+    std::vector<DirectoryEntry> directory(columns_.size());
+    std::string encoded;
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        const Column& column = columns_[c];
+        Encoding encoding = compress_ ? encode(column, encoded) : Encoding::Plain;
+        const std::string& block = encoding == Encoding::Plain ? column.data : encoded;
+
+        pad(file, ALIGNMENT);
+        DirectoryEntry& entry = directory[c];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, column.name.data(), column.name.size());
+        entry.type = static_cast<uint8_t>(column.type);
+        entry.encoding = static_cast<uint8_t>(encoding);
+        entry.rows = column.rows;
+        entry.offset = file.size() - base;
+        entry.bytes = block.size();
+        file.append(block);
+    }
+
+    // Asset dictionary
+    pad(file, 8);
+    uint64_t dictionaryOffset = file.size() - base;
+    uint32_t nameOffset = 0;
+    for (size_t i = 0; i <= assets_.size(); ++i) {
+        file.append(reinterpret_cast<const char*>(&nameOffset), sizeof(nameOffset));
+        if (i < assets_.size()) nameOffset += static_cast<uint32_t>(assets_[i].size());
+    }
+    for (const auto& name : assets_) file.append(name);
+
+    // Directory
+    pad(file, 8);
+    uint64_t directoryOffset = file.size() - base;
+    file.append(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(DirectoryEntry));
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.columnCount = static_cast<uint32_t>(columns_.size());
+    header.dictionarySize = static_cast<uint32_t>(assets_.size());
+    header.directoryOffset = directoryOffset;
+    header.dictionaryOffset = dictionaryOffset;
+    header.fileSize = file.size() - base;
+    std::memcpy(&file[base], &header, sizeof(header));
+}
+
+void ColumnarWriter::write(const std::string& filename) const {
+    TextBuffer out;
+    serialize(out);
+    AsyncFileWriter::writeFile(filename, out);
+}
+
+// Private helper methods
+void ColumnarWriter::addColumn(const std::string& name, Type type, const void* values, size_t rows) {
+    if (name.empty() || name.size() >= NAME_BYTES) {
+        throw std::runtime_error("Column name must be 1 to " + std::to_string(NAME_BYTES - 1) +
+                                 " characters: " + name);
+    }
+    for (const auto& column : columns_) {
+        if (column.name == name) throw std::runtime_error("Duplicate column: " + name);
+    }
+    Column column{name, type, rows, std::string()};
+    column.data.assign(static_cast<const char*>(values), rows * ColumnarStore::typeWidth(type));
+    columns_.push_back(std::move(column));
+}
+
+ColumnarWriter::Encoding ColumnarWriter::encode(const Column& column, std::string& encoded) {
+    encoded.clear();
+    encoded.reserve(column.data.size());
+    bool floating = isFloating(column.type);
+    uint64_t previous = 0;
+    for (size_t i = 0; i < column.rows; ++i) {
+        uint64_t value = load(column.data.data(), i, column.type);
+        if (floating) {
+            putVarint(encoded, value ^ previous);
+        } else {
+            putVarint(encoded, zigzag(static_cast<int64_t>(value - previous)));
+        }
+        previous = value;
+        if (encoded.size() >= column.data.size()) return Encoding::Plain;
+    }
+    return floating ? Encoding::XorDelta : Encoding::Delta;
+}
+
+ColumnarReader::ColumnarReader(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + filename);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_BYTES) {
+        ::close(fd);
+        throw std::runtime_error("Not a columnar result file: " + filename);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Unable to map " + filename);
+    }
+    data_ = static_cast<const unsigned char*>(mapping);
+
+    try {
+        Header header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+            throw std::runtime_error("Not a columnar result file: " + filename);
+        }
+        if (header.fileSize != size_ ||
+            header.directoryOffset + uint64_t(header.columnCount) * ENTRY_BYTES > size_ ||
+            header.dictionaryOffset + (uint64_t(header.dictionarySize) + 1) * 4 > size_) {
+            throw std::runtime_error("Truncated columnar result file: " + filename);
+        }
+
+        // Asset dictionary
+        const unsigned char* offsets = data_ + header.dictionaryOffset;
+        const char* names = reinterpret_cast<const char*>(offsets + (header.dictionarySize + 1) * 4);
+        for (uint32_t i = 0; i < header.dictionarySize; ++i) {
+            uint32_t first, last;
+            std::memcpy(&first, offsets + i * 4, 4);
+            std::memcpy(&last, offsets + (i + 1) * 4, 4);
+            if (last < first || names + last > reinterpret_cast<const char*>(data_ + size_)) {
+                throw std::runtime_error("Corrupt asset dictionary in " + filename);
+            }
+            assets_.emplace_back(names + first, last - first);
+        }
+
+        // Column directory
+        for (uint32_t c = 0; c < header.columnCount; ++c) {
+            DirectoryEntry entry;
+            std::memcpy(&entry, data_ + header.directoryOffset + c * ENTRY_BYTES, sizeof(entry));
+            ColumnInfo column;
+            column.name.assign(entry.name, strnlen(entry.name, NAME_BYTES));
+            column.type = static_cast<Type>(entry.type);
+            column.encoding = static_cast<Encoding>(entry.encoding);
+            column.rows = entry.rows;
+            column.offset = entry.offset;
+            column.bytes = entry.bytes;
+            if (entry.type > static_cast<uint8_t>(Type::AssetId) ||
+                entry.encoding > static_cast<uint8_t>(Encoding::XorDelta) ||
+                column.offset + column.bytes > size_ ||
+                (column.encoding == Encoding::Plain &&
+                 column.bytes != column.rows * ColumnarStore::typeWidth(column.type))) {
+                throw std::runtime_error("Corrupt column " + column.name + " in " + filename);
+            }
+            columns_.push_back(std::move(column));
+        }
+    }
+    catch (...) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+        throw;
+    }
+}
+
+ColumnarReader::~ColumnarReader() {
+    if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+}
+
+bool ColumnarReader::hasColumn(const std::string& name) const {
+    for (const auto& info : columns_) {
+        if (info.name == name) return true;
+    }
+    return false;
+}
+
+const ColumnarReader::ColumnInfo& ColumnarReader::column(const std::string& name) const {
+    for (const auto& info : columns_) {
+        if (info.name == name) return info;
+    }
+    throw std::runtime_error("No column named " + name);
+}
+
+std::vector<double> ColumnarReader::readFloat64(const std::string& name) const {
+    const ColumnInfo& info = expect(name, Type::Float64);
+    std::vector<double> values(info.rows);
+    decode(info, values.data());
+    return values;
+}
+
+std::vector<float> ColumnarReader::readFloat32(const std::string& name) const {
+    const ColumnInfo& info = expect(name, Type::Float32);
+    std::vector<float> values(info.rows);
+    decode(info, values.data());
+    return values;
+}
+
+std::vector<int32_t> ColumnarReader::readInt32(const std::string& name) const {
+    const ColumnInfo& info = column(name);
+    if (info.type != Type::Int32 && info.type != Type::Date) {
+        throw std::runtime_error("Column " + name + " is not an int32 or date column");
+    }
+    std::vector<int32_t> values(info.rows);
+    decode(info, values.data());
+    return values;
+}
+
+std::vector<int64_t> ColumnarReader::readInt64(const std::string& name) const {
+    const ColumnInfo& info = expect(name, Type::Int64);
+    std::vector<int64_t> values(info.rows);
+    decode(info, values.data());
+    return values;
+}
+
+std::vector<uint32_t> ColumnarReader::readAssetIds(const std::string& name) const {
+    const ColumnInfo& info = expect(name, Type::AssetId);
+    std::vector<uint32_t> values(info.rows);
+    decode(info, values.data());
+    return values;
+}
+
+// Private helper methods
+void ColumnarReader::decode(const ColumnInfo& info, void* out) const {
+    const unsigned char* p = data_ + info.offset;
+    const unsigned char* end = p + info.bytes;
+    size_t width = ColumnarStore::typeWidth(info.type);
+    unsigned char* target = static_cast<unsigned char*>(out);
+
+    if (info.encoding == Encoding::Plain) {
+        std::memcpy(target, p, info.bytes);
+        return;
+    }
+
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < info.rows; ++i) {
+        uint64_t raw = getVarint(p, end);
+        uint64_t value = info.encoding == Encoding::XorDelta
+            ? raw ^ previous
+            : previous + static_cast<uint64_t>(unzigzag(raw));
+        store(target, i, value, width);
+        previous = value;
+    }
+}
+
+const ColumnarReader::ColumnInfo& ColumnarReader::expect(const std::string& name, Type type) const {
+    const ColumnInfo& info = column(name);
+    if (info.type != type) {
+        throw std::runtime_error("Column " + name + " has a different type");
+    }
+    return info;
+}
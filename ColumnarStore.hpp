@@ -0,0 +1,135 @@
+#pragma once
+#include "AsyncWriter.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Binary columnar result files. Every column is a typed array stored in its
+// own 64-byte aligned block, so a reader can mmap the file and pull single
+// columns without parsing the rest. Asset names live once in a dictionary
+// and asset columns hold uint32 indices into it.
+//
+// Layout (little-endian):
+//   header      64 bytes: magic "PFCOLUMN", version, column count,
+//               dictionary size, directory/dictionary offsets, file size
+//   columns     one block per column, 64-byte aligned
+//   dictionary  uint32 offsets[size + 1] followed by the name bytes
+//   directory   one 80-byte entry per column (name, type, encoding,
+//               rows, offset, bytes)
+//
+// With compression enabled integer columns are stored as zigzag varint
+// deltas and floating columns as varint XOR against the previous value;
+// a column keeps the plain encoding when that is not smaller. Only plain
+// columns can be viewed in place.
+class ColumnarStore {
+public:
+    enum class Type : uint8_t {
+        Float64 = 0,
+        Float32 = 1,
+        Int32 = 2,
+        Int64 = 3,
+        Date = 4,       // int32 day numbers (TradingCalendar::dayNumber)
+        AssetId = 5     // uint32 index into the asset dictionary
+    };
+
+    enum class Encoding : uint8_t {
+        Plain = 0,
+        Delta = 1,      // zigzag varint of successive differences
+        XorDelta = 2    // varint of the bit pattern XOR the previous one
+    };
+
+    static size_t typeWidth(Type type);
+};
+
+class ColumnarWriter {
+public:
+    using Type = ColumnarStore::Type;
+    using Encoding = ColumnarStore::Encoding;
+
+    explicit ColumnarWriter(bool compress = false) : compress_(compress) {}
+
+    void setAssets(const std::vector<std::string>& names) { assets_ = names; }
+
+    void addFloat64(const std::string& name, const std::vector<double>& values);
+    void addFloat32(const std::string& name, const std::vector<float>& values);
+    void addInt32(const std::string& name, const std::vector<int32_t>& values);
+    void addInt64(const std::string& name, const std::vector<int64_t>& values);
+    void addDates(const std::string& name, const std::vector<int32_t>& days);
+    void addAssetIds(const std::string& name, const std::vector<uint32_t>& ids);
+
+    // Encodes every column; intended to run on the export thread
+    void serialize(TextBuffer& out) const;
+    void write(const std::string& filename) const;
+
+private:
+    struct Column {
+        std::string name;
+        Type type;
+        uint64_t rows;
+        std::string data;   // plain little-endian values
+    };
+
+    bool compress_;
+    std::vector<std::string> assets_;
+    std::vector<Column> columns_;
+
+    // Private helper methods
+    void addColumn(const std::string& name, Type type, const void* values, size_t rows);
+    static Encoding encode(const Column& column, std::string& encoded);
+};
+
+class ColumnarReader {
+public:
+    using Type = ColumnarStore::Type;
+    using Encoding = ColumnarStore::Encoding;
+
+    struct ColumnInfo {
+        std::string name;
+        Type type;
+        Encoding encoding;
+        uint64_t rows;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+
+    // Maps the file read-only; columns are decoded on request
+    explicit ColumnarReader(const std::string& filename);
+    ~ColumnarReader();
+
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    const std::vector<ColumnInfo>& columns() const { return columns_; }
+    const std::vector<std::string>& assets() const { return assets_; }
+    bool hasColumn(const std::string& name) const;
+    const ColumnInfo& column(const std::string& name) const;
+
+    std::vector<double> readFloat64(const std::string& name) const;
+    std::vector<float> readFloat32(const std::string& name) const;
+    std::vector<int32_t> readInt32(const std::string& name) const;     // Int32 and Date
+    std::vector<int64_t> readInt64(const std::string& name) const;
+    std::vector<uint32_t> readAssetIds(const std::string& name) const;
+
+    // Zero-copy pointer into the mapping for a plain column of width
+    // sizeof(T); nullptr when the column is delta encoded
+    template<typename T>
+    const T* view(const std::string& name) const {
+        const ColumnInfo& info = column(name);
+        if (ColumnarStore::typeWidth(info.type) != sizeof(T)) {
+            throw std::runtime_error("Column " + name + " has a different element width");
+        }
+        if (info.encoding != Encoding::Plain) return nullptr;
+        return reinterpret_cast<const T*>(data_ + info.offset);
+    }
+
+private:
+    const unsigned char* data_{nullptr};
+    size_t size_{0};
+    std::vector<ColumnInfo> columns_;
+    std::vector<std::string> assets_;
+
+    // Private helper methods
+    void decode(const ColumnInfo& info, void* out) const;
+    const ColumnInfo& expect(const std::string& name, Type type) const;
+};
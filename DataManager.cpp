@@ -1,41 +1,57 @@
 #include "DataManager.hpp"
-#include "Parser.hpp"
+#include "ParallelCSVLoader.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
 #include <stdexcept>
 #include <numeric>
 #include <algorithm>
-#include <iostream>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+const boost::gregorian::date_duration DataManager::MAX_GAP(5);
 
 void DataManager::loadData(const std::string& filename, 
-                         const std::string& dateFormat,
-                         bool adjustForDividends) {
+                         [[maybe_unused]] const std::string& dateFormat,
+                         bool adjustForDividends,
+                         unsigned int numThreads) {
     try {
-        Parser portfolio(filename);
-        dates_.clear();
+        PROFILE_SCOPE("load");
+        ALLOCATION_SCOPE("load");
+        ParallelCSVLoader loader(numThreads);
+        ParallelCSVLoader::Table table = loader.load(filename);
+        
+        size_t numFields = table.header.size() - 1;
+        if (numFields == 0 || numFields % FIELDS_PER_ASSET != 0) {
+            throw std::runtime_error("Expected date followed by price, adjusted close and volume per asset");
+        }
+        
+        dates_ = std::move(table.dates);
+        calendar_ = TradingCalendar(dates_);
         marketData_.clear();
+        covarianceMatrix_.reset();
+        correlationMatrix_.reset();
+        liveStatistics_.reset();
+        sourceFile_ = filename;
+        tailOffset_ = static_cast<std::streamoff>(table.bytesRead);
+        adjustForDividends_ = adjustForDividends;
         
-        // Process data row by row
-        for (size_t i = 1; i < portfolio.rowCount(); ++i) {
-            boost::gregorian::date date = 
-                boost::gregorian::from_string(portfolio[i][0]);
-            dates_.push_back(date);
-            
-            for (size_t j = 0; j < portfolio.columnCount() - 1; ++j) {
-                MarketData data;
-                data.date = date;
-                data.price = std::stod(portfolio[i][j + 1]);
-                if (adjustForDividends) {
-                    data.adjustedClose = std::stod(portfolio[i][j + 2]);
-                } else {
-                    data.adjustedClose = data.price;
-                }
-                data.volume = std::stod(portfolio[i][j + 3]);
-                
-                marketData_[portfolio[0][j + 1]].push_back(data);
+        // Move parsed columns into their asset slots; no per-cell lookups
+        for (size_t base = 1; base < table.header.size(); base += FIELDS_PER_ASSET) {
+            marketData_.symbols.push_back(table.header[base]);
+            marketData_.prices.push_back(std::move(table.columns[base]));
+            if (adjustForDividends) {
+                marketData_.adjustedClose.push_back(std::move(table.columns[base + 1]));
+            } else {
+                marketData_.adjustedClose.push_back(marketData_.prices.back());
             }
+            marketData_.volumes.push_back(std::move(table.columns[base + 2]));
         }
         
-        calculateReturns();
         validateData();
+        calculateReturns();
         
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to load data: " + std::string(e.what()));
@@ -43,190 +59,401 @@ void DataManager::loadData(const std::string& filename,
 }
 
 void DataManager::calculateReturns() {
-    size_t numAssets = marketData_.size();
-    size_t numDays = dates_.size();
+    size_t numAssets = marketData_.assetCount();
+    size_t numRows = dates_.size() > 1 ? dates_.size() - 1 : 0;
     
-    returns_ = Matrix(numDays - 1, numAssets);
-    excessReturns_ = Matrix(numDays - 1, numAssets);
+    returns_ = ReturnPanel(0, numAssets);
+    excessReturns_ = ReturnPanel(0, numAssets);
+    returns_.reserveRows(numRows);
+    excessReturns_.reserveRows(numRows);
+    returnsSingle_ = ReturnPanelF(0, numAssets);
+    syncReturns();
+}
+
+void DataManager::syncReturns() {
+    size_t numAssets = marketData_.assetCount();
+    size_t numRows = dates_.size() > 1 ? dates_.size() - 1 : 0;
     
-    size_t col = 0;
-    for (const auto& [symbol, data] : marketData_) {
-        for (size_t i = 1; i < data.size(); ++i) {
-            double ret = (data[i].adjustedClose / data[i-1].adjustedClose) - 1.0;
-            returns_[i-1][col] = ret;
-            excessReturns_[i-1][col] = ret - benchmarkReturns_[i-1][0];
+    // Append the rows added since the last sync; earlier rows are not touched
+    std::vector<double> row(numAssets), excess(numAssets);
+    for (size_t i = returns_.rows(); i < numRows; ++i) {
+        double benchmark = benchmarkReturn(i);
+        for (size_t col = 0; col < numAssets; ++col) {
+            const std::vector<double>& closes = marketData_.adjustedClose[col];
+            row[col] = (closes[i+1] / closes[i]) - 1.0;
+            excess[col] = row[col] - benchmark;
+        }
+        returns_.appendRow(row.data());
+        excessReturns_.appendRow(excess.data());
+        if (singlePrecision_) {
+            returnsSingle_.appendRow(row.data());
         }
-        ++col;
     }
 }
 
-void DataManager::validateData() {
-    validateDateContinuity();
-    detectOutliers();
-    checkMissingValues();
+const Matrix& DataManager::denseReturns() {
+    syncReturns();
+    if (returnsMatrix_.rows() != returns_.rows()) {
+        returnsMatrix_ = returns_.toMatrix();
+    }
+    return returnsMatrix_;
 }
 
-void DataManager::validateDateContinuity() {
-    for (size_t i = 1; i < dates_.size(); ++i) {
-        auto diff = dates_[i] - dates_[i-1];
-        if (diff.days() > 5) {
-            throw std::runtime_error("Data gap detected between " + 
-                boost::gregorian::to_simple_string(dates_[i-1]) + " and " + 
-                boost::gregorian::to_simple_string(dates_[i]));
+const Matrix& DataManager::getExcessReturns() {
+    syncReturns();
+    if (excessReturnsMatrix_.rows() != excessReturns_.rows()) {
+        excessReturnsMatrix_ = excessReturns_.toMatrix();
+    }
+    return excessReturnsMatrix_;
+}
+
+void DataManager::setBenchmarkReturns(const Matrix& benchmarkReturns) {
+    if (!benchmarkReturns.empty() && benchmarkReturns.columns() != 1) {
+        throw std::runtime_error("Benchmark returns must be a single column");
+    }
+    syncReturns();
+    benchmarkReturns_ = benchmarkReturns;
+    for (size_t i = 0; i < returns_.rows(); ++i) {
+        double benchmark = benchmarkReturn(i);
+        for (size_t col = 0; col < returns_.columns(); ++col) {
+            excessReturns_(i, col) = returns_(i, col) - benchmark;
         }
     }
+    excessReturnsMatrix_ = Matrix();
 }
 
-void DataManager::detectOutliers() {
-    for (auto& [symbol, data] : marketData_) {
-        std::vector<double> prices;
-        prices.reserve(data.size());
-        for (const auto& point : data) {
-            prices.push_back(point.price);
+void DataManager::appendRow(const boost::gregorian::date& date,
+                          const std::vector<double>& prices,
+                          const std::vector<double>& adjustedClose,
+                          const std::vector<double>& volumes) {
+    try {
+        ALLOCATION_SCOPE("append");
+        size_t numAssets = marketData_.assetCount();
+        if (prices.size() != numAssets || adjustedClose.size() != numAssets ||
+            volumes.size() != numAssets) {
+            throw std::runtime_error("Row does not match the number of assets");
+        }
+        if (!dates_.empty() && date <= dates_.back()) {
+            throw std::runtime_error("Appended rows must be in date order, got " +
+                boost::gregorian::to_simple_string(date) + " after " +
+                boost::gregorian::to_simple_string(dates_.back()));
         }
         
-        double mean = std::accumulate(prices.begin(), prices.end(), 0.0) / prices.size();
-        double sqSum = std::inner_product(prices.begin(), prices.end(), 
-                                        prices.begin(), 0.0);
-        double stdDev = std::sqrt(sqSum / prices.size() - mean * mean);
+        calendar_.append(date);
+        dates_.push_back(date);
+        for (size_t asset = 0; asset < numAssets; ++asset) {
+            double close = adjustForDividends_ ? adjustedClose[asset] : prices[asset];
+            if (!std::isfinite(prices[asset]) || !std::isfinite(close)) {
+                marketData_.prices[asset].push_back(std::numeric_limits<double>::quiet_NaN());
+                marketData_.adjustedClose[asset].push_back(std::numeric_limits<double>::quiet_NaN());
+                ++missingCounts_[asset];
+                hasMissingData_ = true;
+            } else {
+                marketData_.prices[asset].push_back(prices[asset]);
+                marketData_.adjustedClose[asset].push_back(close);
+            }
+            marketData_.volumes[asset].push_back(volumes[asset]);
+        }
+        if (dates_.size() > 1 && dates_[dates_.size() - 1] - dates_[dates_.size() - 2] > MAX_GAP) {
+            dataGaps_.emplace_back(dates_[dates_.size() - 2], dates_.back());
+        }
         
-        for (size_t i = 0; i < prices.size(); ++i) {
-            if (std::abs(prices[i] - mean) > 5 * stdDev) {
-                std::cerr << "Warning: Outlier detected in " << symbol 
-                         << " at date " << boost::gregorian::to_simple_string(data[i].date) 
-                         << std::endl;
+        if (dates_.size() > 1) {
+            lastReturns_.resize(numAssets);
+            for (size_t asset = 0; asset < numAssets; ++asset) {
+                const std::vector<double>& closes = marketData_.adjustedClose[asset];
+                lastReturns_[asset] = closes[closes.size() - 1] / closes[closes.size() - 2] - 1.0;
+            }
+            if (liveStatistics_) {
+                liveStatistics_->update(lastReturns_);
             }
         }
+        
+        covarianceMatrix_.reset();
+        correlationMatrix_.reset();
+        
+        if (updateCallback_) {
+            updateCallback_(date);
+        }
+        
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in appendRow: " + std::string(e.what()));
     }
 }
 
-void DataManager::checkMissingValues() {
-    for (const auto& [symbol, data] : marketData_) {
-        for (const auto& point : data) {
-            if (std::isnan(point.price) || std::isinf(point.price)) {
-                throw std::runtime_error("Invalid price data for " + symbol + 
-                    " at date " + boost::gregorian::to_simple_string(point.date));
+size_t DataManager::tailFile() {
+    try {
+        if (sourceFile_.empty()) {
+            throw std::runtime_error("No file loaded");
+        }
+        
+        std::ifstream file(sourceFile_, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + sourceFile_);
+        }
+        std::streamoff fileSize = file.tellg();
+        if (fileSize <= tailOffset_) return 0;
+        
+        std::string content(static_cast<size_t>(fileSize - tailOffset_), '\0');
+        file.seekg(tailOffset_);
+        file.read(&content[0], content.size());
+        
+        // Only complete lines; a partially written last row waits for the next call
+        size_t consumed = content.rfind('\n');
+        if (consumed == std::string::npos) return 0;
+        ++consumed;
+        
+        size_t numAssets = marketData_.assetCount();
+        std::vector<double> prices(numAssets), adjustedClose(numAssets), volumes(numAssets);
+        std::vector<double> fields;
+        fields.reserve(numAssets * FIELDS_PER_ASSET);
+        size_t appended = 0;
+        
+        // The offset advances row by row, so a bad row leaves the ones before
+        // it committed and a retry resumes at the bad row
+        const std::streamoff start = tailOffset_;
+        size_t lineStart = 0;
+        while (lineStart < consumed) {
+            size_t lineEnd = content.find('\n', lineStart);
+            const char* begin = content.data() + lineStart;
+            const char* end = content.data() + lineEnd;
+            if (end > begin && end[-1] == '\r') --end;
+            lineStart = lineEnd + 1;
+            if (end == begin) continue;
+            
+            const char* comma = std::find(begin, end, ',');
+            boost::gregorian::date date = ParallelCSVLoader::parseDate(begin, comma);
+            fields.clear();
+            while (comma != end) {
+                const char* fieldStart = comma + 1;
+                comma = std::find(fieldStart, end, ',');
+                fields.push_back(ParallelCSVLoader::parseNumber(fieldStart, comma));
+            }
+            if (fields.size() != numAssets * FIELDS_PER_ASSET) {
+                throw std::runtime_error("Wrong number of fields in row dated " +
+                    boost::gregorian::to_simple_string(date));
             }
+            
+            for (size_t asset = 0; asset < numAssets; ++asset) {
+                prices[asset] = fields[asset * FIELDS_PER_ASSET];
+                adjustedClose[asset] = fields[asset * FIELDS_PER_ASSET + 1];
+                volumes[asset] = fields[asset * FIELDS_PER_ASSET + 2];
+            }
+            appendRow(date, prices, adjustedClose, volumes);
+            tailOffset_ = start + static_cast<std::streamoff>(lineStart);
+            ++appended;
         }
+        
+        tailOffset_ = start + static_cast<std::streamoff>(consumed);
+        return appended;
+        
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in tailFile: " + std::string(e.what()));
     }
 }
 
-double DataManager::calculateBeta(const Matrix& assetReturns, 
-                                const Matrix& benchmarkReturns) {
-    double covariance = 0.0;
-    double benchmarkVariance = 0.0;
-    double meanAsset = 0.0;
-    double meanBenchmark = 0.0;
-    
-    // Calculate means
-    for (Size i = 0; i < assetReturns.rows(); ++i) {
-        meanAsset += assetReturns[i][0];
-        meanBenchmark += benchmarkReturns[i][0];
-    }
-    meanAsset /= assetReturns.rows();
-    meanBenchmark /= benchmarkReturns.rows();
-    
-    // Calculate covariance and variance
-    for (Size i = 0; i < assetReturns.rows(); ++i) {
-        covariance += (assetReturns[i][0] - meanAsset) * 
-                     (benchmarkReturns[i][0] - meanBenchmark);
-        benchmarkVariance += std::pow(benchmarkReturns[i][0] - meanBenchmark, 2);
+void DataManager::enableLiveStatistics(size_t windowSize, double ewmaLambda) {
+    try {
+        syncReturns();
+        liveStatistics_ = std::make_unique<IncrementalStatistics>(
+            marketData_.assetCount(), windowSize, ewmaLambda);
+        
+        // Replay the history once; later rows are folded in by appendRow
+        std::vector<double> row(returns_.columns());
+        for (size_t i = 0; i < returns_.rows(); ++i) {
+            returns_.copyRow(i, row.data());
+            liveStatistics_->update(row);
+        }
+        
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in enableLiveStatistics: " + std::string(e.what()));
     }
-    
-    covariance /= (assetReturns.rows() - 1);
-    benchmarkVariance /= (benchmarkReturns.rows() - 1);
-    
-    return covariance / benchmarkVariance;
 }
 
-double DataManager::calculateVolatility(const Matrix& returns) {
-    double mean = 0.0;
-    double variance = 0.0;
-    
-    // Calculate mean
-    for (Size i = 0; i < returns.rows(); ++i) {
-        mean += returns[i][0];
+const IncrementalStatistics& DataManager::getLiveStatistics() const {
+    if (!liveStatistics_) {
+        throw std::runtime_error("Live statistics are not enabled");
     }
-    mean /= returns.rows();
-    
-    // Calculate variance
-    for (Size i = 0; i < returns.rows(); ++i) {
-        variance += std::pow(returns[i][0] - mean, 2);
+    return *liveStatistics_;
+}
+
+void DataManager::setSinglePrecision(bool enabled) {
+    syncReturns();
+    singlePrecision_ = enabled;
+    returnsSingle_ = enabled ? ReturnPanelF(returns_) : ReturnPanelF();
+    covarianceMatrix_.reset();
+    correlationMatrix_.reset();
+}
+
+void DataManager::validateData() {
+    validateDateContinuity();
+    checkMissingValues();
+    detectOutliers();
+}
+
+void DataManager::validateDateContinuity() {
+    // Gaps (holidays, exchange closures) are recorded, not fatal
+    dataGaps_.clear();
+    for (size_t i = 1; i < dates_.size(); ++i) {
+        if (dates_[i] - dates_[i-1] > MAX_GAP) {
+            dataGaps_.emplace_back(dates_[i-1], dates_[i]);
+        }
     }
-    variance /= (returns.rows() - 1);
-    
-    // Annualize volatility (sqrt(252) for daily data)
-    return std::sqrt(variance * 252);
 }
 
-Matrix DataManager::calculateRollingBeta(int windowSize) {
-    size_t numAssets = marketData_.size();
-    size_t numDays = dates_.size();
-    Matrix betas(numDays - windowSize, numAssets);
+void DataManager::detectOutliers() {
+    // Robust z-score of each daily return against the asset's median and
+    // MAD; a bad tick shows up as a return far outside the usual spread
+    size_t numAssets = marketData_.assetCount();
+    size_t numThreads = outlierParams_.numThreads ? outlierParams_.numThreads
+                                                   : std::thread::hardware_concurrency();
+    numThreads = std::max<size_t>(1, std::min(numThreads, numAssets));
     
-    for (size_t i = windowSize; i < numDays; ++i) {
-        Matrix windowReturns = returns_.range(i - windowSize, i, 0, numAssets);
-        Matrix windowBenchmark = benchmarkReturns_.range(i - windowSize, i, 0, 1);
-        
-        for (size_t j = 0; j < numAssets; ++j) {
-            betas[i-windowSize][j] = calculateBeta(windowReturns.column(j), 
-                                                 windowBenchmark.column(0));
+    std::vector<std::vector<OutlierHit>> hits(numThreads);
+    auto screen = [&](size_t worker) {
+        std::vector<double> returns, deviations;
+        for (size_t asset = worker; asset < numAssets; asset += numThreads) {
+            const std::vector<double>& closes = marketData_.adjustedClose[asset];
+            returns.clear();
+            for (size_t i = 1; i < closes.size(); ++i) {
+                double ret = closes[i] / closes[i-1] - 1.0;
+                if (!std::isnan(ret)) returns.push_back(ret);
+            }
+            if (returns.size() < 3) continue;
+            
+            deviations = returns;
+            size_t mid = deviations.size() / 2;
+            std::nth_element(deviations.begin(), deviations.begin() + mid, deviations.end());
+            double median = deviations[mid];
+            for (double& value : deviations) value = std::abs(value - median);
+            std::nth_element(deviations.begin(), deviations.begin() + mid, deviations.end());
+            double scale = 1.4826 * deviations[mid];   // MAD -> sigma for normal data
+            if (scale <= 0.0) continue;
+            
+            for (size_t i = 1; i < closes.size(); ++i) {
+                double score = std::abs(closes[i] / closes[i-1] - 1.0 - median) / scale;
+                if (score > outlierParams_.threshold) {
+                    hits[worker].push_back(OutlierHit{static_cast<uint32_t>(asset),
+                        static_cast<uint32_t>(i), static_cast<float>(score)});
+                }
+            }
         }
+    };
+    
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k < numThreads; ++k) {
+        workers.emplace_back(screen, k);
     }
+    screen(0);
+    for (auto& worker : workers) worker.join();
     
-    return betas;
+    outliers_.clear();
+    for (const auto& local : hits) {
+        outliers_.insert(outliers_.end(), local.begin(), local.end());
+    }
+    std::sort(outliers_.begin(), outliers_.end(), [](const OutlierHit& a, const OutlierHit& b) {
+        return a.asset != b.asset ? a.asset < b.asset : a.row < b.row;
+    });
 }
 
-Matrix DataManager::calculateRollingVolatility(int windowSize) {
-    size_t numAssets = marketData_.size();
-    size_t numDays = dates_.size();
-    Matrix vols(numDays - windowSize, numAssets);
-    
-    for (size_t i = windowSize; i < numDays; ++i) {
-        Matrix windowReturns = returns_.range(i - windowSize, i, 0, numAssets);
-        
-        for (size_t j = 0; j < numAssets; ++j) {
-            vols[i-windowSize][j] = calculateVolatility(windowReturns.column(j));
+void DataManager::setOutlierParameters(const OutlierParameters& params) {
+    outlierParams_ = params;
+    if (!dates_.empty()) {
+        detectOutliers();
+    }
+}
+
+void DataManager::checkMissingValues() {
+    // Unobserved prices (before an IPO, after a delisting, during a halt)
+    // are normalized to NaN; the returns they touch are masked downstream
+    missingCounts_.assign(marketData_.assetCount(), 0);
+    hasMissingData_ = false;
+    for (size_t asset = 0; asset < marketData_.assetCount(); ++asset) {
+        std::vector<double>& prices = marketData_.prices[asset];
+        std::vector<double>& closes = marketData_.adjustedClose[asset];
+        for (size_t i = 0; i < prices.size(); ++i) {
+            if (!std::isfinite(prices[i]) || !std::isfinite(closes[i])) {
+                prices[i] = std::numeric_limits<double>::quiet_NaN();
+                closes[i] = std::numeric_limits<double>::quiet_NaN();
+                ++missingCounts_[asset];
+            }
         }
+        if (missingCounts_[asset] == prices.size()) {
+            throw std::runtime_error("No price data for " + marketData_.symbols[asset]);
+        }
+        hasMissingData_ = hasMissingData_ || missingCounts_[asset] > 0;
     }
-    
-    return vols;
 }
 
-std::vector<double> DataManager::calculateDrawdowns() {
-    std::vector<double> drawdowns;
-    drawdowns.reserve(dates_.size());
-    
-    double peak = 1.0;
-    double value = 1.0;
-    
-    for (size_t i = 0; i < returns_.rows(); ++i) {
-        value *= (1 + returns_[i][0]);
-        peak = std::max(peak, value);
-        drawdowns.push_back((peak - value) / peak);
+Matrix DataManager::calculateRollingBeta(int windowSize) {
+    return calculateRollingMetric(windowSize, RollingAnalytics::BETA);
+}
+
+Matrix DataManager::calculateRollingVolatility(int windowSize) {
+    return calculateRollingMetric(windowSize, RollingAnalytics::VOLATILITY);
+}
+
+Matrix DataManager::calculateRollingMetric(int windowSize, RollingAnalytics::Metric metric) {
+    syncReturns();
+    if (windowSize < 2 || static_cast<size_t>(windowSize) > returns_.rows()) {
+        throw std::runtime_error("Rolling window must be between 2 and the number of return rows");
     }
-    
+
+    bool needsBenchmark = metric == RollingAnalytics::BETA || metric == RollingAnalytics::TRACKING_ERROR;
+    if (needsBenchmark && !hasBenchmark()) {
+        throw std::runtime_error("Rolling beta and tracking error need benchmark returns; call setBenchmarkReturns");
+    }
+
+    // Benchmark rows not loaded count as zero, as in syncReturns
+    std::vector<double> benchmark(returns_.rows(), 0.0);
+    for (size_t i = 0; i < benchmark.size() && i < benchmarkReturns_.rows(); ++i) {
+        benchmark[i] = benchmarkReturns_[i][0];
+    }
+
+    RollingAnalytics::RollingParameters parameters;
+    parameters.windowSize = windowSize;
+    Matrix series = RollingAnalytics::compute(denseReturns(), benchmark, parameters)[metric];
+
+    // Row k is the window ending at return row k + windowSize - 1
+    Matrix result(series.rows() - windowSize + 1, series.columns());
+    std::copy(series[windowSize - 1], series.end(), result.begin());
+    return result;
+}
+
+Matrix DataManager::calculateDrawdowns() {
+    Matrix drawdowns;
+    DrawdownEngine::analyze(denseReturns(), &drawdowns);
     return drawdowns;
 }
 
-const Matrix& DataManager::getCorrelationMatrix() {
+std::vector<DrawdownEngine::DrawdownStatistics> DataManager::calculateDrawdownStatistics() {
+    return DrawdownEngine::analyze(denseReturns());
+}
+
+Matrix DataManager::calculateRollingMaxDrawdown(int windowSize) {
+    return DrawdownEngine::rollingMaxDrawdown(denseReturns(), windowSize);
+}
+
+const SymmetricMatrix& DataManager::getCorrelationMatrix() {
     if (!correlationMatrix_) {
-        // Calculate if not cached
-        correlationMatrix_ = std::make_unique<Matrix>(returns_.columns(), 
-                                                    returns_.columns());
-        // Calculate correlation matrix
-        // ... implementation details
+        // Calculate if not cached, scaling the cached covariance
+        correlationMatrix_ = std::make_unique<SymmetricMatrix>(
+            MatrixOperations::correlationFromCovariance(getCovarianceMatrix()));
     }
     return *correlationMatrix_;
 }
 
-const Matrix& DataManager::getCovarianceMatrix() {
+const SymmetricMatrix& DataManager::getCovarianceMatrix() {
     if (!covarianceMatrix_) {
-        // Calculate if not cached
-        covarianceMatrix_ = std::make_unique<Matrix>(returns_.columns(), 
-                                                   returns_.columns());
-        // Calculate covariance matrix
-        // ... implementation details
+        PROFILE_SCOPE("covariance");
+        syncReturns();
+        // Calculate if not cached, in place from the panel; pairwise-complete
+        // when there are gaps
+        if (singlePrecision_) {
+            covarianceMatrix_ = std::make_unique<SymmetricMatrix>(returnsSingle_.covariance());
+        } else {
+            covarianceMatrix_ = std::make_unique<SymmetricMatrix>(returns_.covariance());
+        }
     }
     return *covarianceMatrix_;
-}
\ No newline at end of file
+}
@@ -3,58 +3,168 @@
 #include <memory>
 #include <unordered_map>
 #include <boost/date_time.hpp>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
-
-class Parser; // Forward declaration
+#include "SymmetricMatrix.hpp"
+#include "ReturnPanel.hpp"
+#include "IncrementalStatistics.hpp"
+#include "TradingCalendar.hpp"
+#include "DrawdownEngine.hpp"
+#include "RollingAnalytics.hpp"
 
 class DataManager {
+public:
+    // Return-based outlier screen: |r - median| / (1.4826 MAD) per asset
+    struct OutlierParameters {
+        double threshold{8.0};          // robust z-score above which a return is flagged
+        unsigned int numThreads{0};     // 0 = hardware concurrency
+        OutlierParameters() = default;
+    };
+
+    // One flagged return: asset column, date row it ends on, robust z-score
+    struct OutlierHit {
+        uint32_t asset;
+        uint32_t row;
+        float score;
+    };
+
 private:
+    // Column-oriented market data, one slot per asset in file column order
     struct MarketData {
-        boost::gregorian::date date;
-        double price;
-        double volume;
-        double adjustedClose;
+        std::vector<std::string> symbols;
+        std::vector<std::vector<double>> prices;
+        std::vector<std::vector<double>> adjustedClose;
+        std::vector<std::vector<double>> volumes;
+
+        size_t assetCount() const { return symbols.size(); }
+        void clear() {
+            symbols.clear();
+            prices.clear();
+            adjustedClose.clear();
+            volumes.clear();
+        }
     };
 
-    std::unordered_map<std::string, std::vector<MarketData>> marketData_;
-    Matrix returns_;
-    Matrix excessReturns_;
-    Matrix benchmarkReturns_;
+    // File layout: date, then (price, adjusted close, volume) per asset
+    static constexpr size_t FIELDS_PER_ASSET = 3;
+
+    // Calendar gaps longer than this are reported by getDataGaps()
+    static const boost::gregorian::date_duration MAX_GAP;
+
+    MarketData marketData_;
+    // Append-only return panels (oldest-first, amortized O(N) per new row).
+    // The dense copies behind getReturns() are rebuilt only when a Matrix is
+    // asked for after rows were added.
+    ReturnPanel returns_;
+    ReturnPanel excessReturns_;
+    Matrix returnsMatrix_;
+    Matrix excessReturnsMatrix_;
+    Matrix benchmarkReturns_;           // one column per return row; rows not set count as zero
     std::vector<boost::gregorian::date> dates_;
+    TradingCalendar calendar_;
+
+    // Missing observations are kept as NaN prices (and NaN returns)
+    bool hasMissingData_{false};
+    std::vector<size_t> missingCounts_;
+    std::vector<std::pair<boost::gregorian::date, boost::gregorian::date>> dataGaps_;
+
+    OutlierParameters outlierParams_;
+    std::vector<OutlierHit> outliers_;
     
-    // Cache for performance
-    std::unique_ptr<Matrix> correlationMatrix_;
-    std::unique_ptr<Matrix> covarianceMatrix_;
+    // Optional float32 copy of returns_ (float64 accumulation)
+    bool singlePrecision_{false};
+    ReturnPanelF returnsSingle_;
+    
+    // Cache for performance (packed symmetric storage, half the memory of dense)
+    std::unique_ptr<SymmetricMatrix> correlationMatrix_;
+    std::unique_ptr<SymmetricMatrix> covarianceMatrix_;
+
+    // Live ingestion: appended rows go straight into marketData_; the
+    // return panels are extended when returns are next asked for
+    std::string sourceFile_;
+    std::streamoff tailOffset_{0};
+    bool adjustForDividends_{true};
+    std::vector<double> lastReturns_;
+    std::unique_ptr<IncrementalStatistics> liveStatistics_;
+    std::function<void(const boost::gregorian::date&)> updateCallback_;
 
     // Private helper methods
     void calculateReturns();
+    void syncReturns();
+    const Matrix& denseReturns();
+    double benchmarkReturn(size_t row) const {
+        return row < benchmarkReturns_.rows() ? benchmarkReturns_[row][0] : 0.0;
+    }
     void validateData();
     void validateDateContinuity();
     void detectOutliers();
     void checkMissingValues();
-    double calculateBeta(const Matrix& assetReturns, const Matrix& benchmarkReturns);
-    double calculateVolatility(const Matrix& returns);
+    Matrix calculateRollingMetric(int windowSize, RollingAnalytics::Metric metric);
 
 public:
     // Constructor
     DataManager() = default;
     
-    // Main data loading method
+    // Main data loading method (parses in parallel, one chunk per thread).
+    // dateFormat is kept for source compatibility and ignored: the loader
+    // detects YYYY-MM-DD and M/D/YYYY dates itself
     void loadData(const std::string& filename, 
                  const std::string& dateFormat = "%Y-%m-%d",
-                 bool adjustForDividends = true);
+                 bool adjustForDividends = true,
+                 unsigned int numThreads = 0);
 
-    // Analysis methods
+    // Live ingestion. appendRow costs O(N^2) with live statistics enabled
+    // and O(N) otherwise; tailFile ingests rows written to the loaded file
+    // since the last load/tail and returns how many were appended.
+    void appendRow(const boost::gregorian::date& date,
+                   const std::vector<double>& prices,
+                   const std::vector<double>& adjustedClose,
+                   const std::vector<double>& volumes);
+    size_t tailFile();
+    void enableLiveStatistics(size_t windowSize = 252, double ewmaLambda = 0.94);
+    const IncrementalStatistics& getLiveStatistics() const;
+    void setUpdateCallback(std::function<void(const boost::gregorian::date&)> callback) {
+        updateCallback_ = std::move(callback);
+    }
+
+    // Outlier screen runs on load; changing the parameters re-screens
+    void setOutlierParameters(const OutlierParameters& params);
+    const std::vector<OutlierHit>& getOutliers() const { return outliers_; }
+
+    // Opt-in float32 return storage for the covariance sweep
+    void setSinglePrecision(bool enabled);
+    bool isSinglePrecision() const { return singlePrecision_; }
+
+    // Analysis methods; rolling rows are the windows ending at return rows
+    // windowSize - 1 .. T - 1, volatility annualized. Beta throws until
+    // benchmark returns are set.
     Matrix calculateRollingBeta(int windowSize = 60);
     Matrix calculateRollingVolatility(int windowSize = 20);
-    std::vector<double> calculateDrawdowns();
+    // Per-asset drawdown series (T x N), statistics and rolling max drawdown
+    Matrix calculateDrawdowns();
+    std::vector<DrawdownEngine::DrawdownStatistics> calculateDrawdownStatistics();
+    Matrix calculateRollingMaxDrawdown(int windowSize = 63);
+
+    // Benchmark returns aligned with the return rows (chronological, T x 1);
+    // recomputes the excess returns
+    void setBenchmarkReturns(const Matrix& benchmarkReturns);
+    bool hasBenchmark() const { return !benchmarkReturns_.empty(); }
 
     // Getters
-    const Matrix& getReturns() const { return returns_; }
-    const Matrix& getExcessReturns() const { return excessReturns_; }
+    const Matrix& getReturns() { return denseReturns(); }
+    const Matrix& getExcessReturns();
+    const ReturnPanel& getReturnPanel() { syncReturns(); return returns_; }
     const Matrix& getBenchmarkReturns() const { return benchmarkReturns_; }
     const std::vector<boost::gregorian::date>& getDates() const { return dates_; }
-    const Matrix& getCorrelationMatrix();
-    const Matrix& getCovarianceMatrix();
+    const TradingCalendar& getCalendar() const { return calendar_; }
+    bool hasMissingData() const { return hasMissingData_; }
+    const std::vector<size_t>& getMissingCounts() const { return missingCounts_; }
+    const std::vector<std::pair<boost::gregorian::date, boost::gregorian::date>>& getDataGaps() const {
+        return dataGaps_;
+    }
+    const ReturnPanelF& getSinglePrecisionReturns() { syncReturns(); return returnsSingle_; }
+    const SymmetricMatrix& getCorrelationMatrix();
+    const SymmetricMatrix& getCovarianceMatrix();
 };
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "DrawdownEngine.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+double DrawdownEngine::maxDrawdown(const double* returns, size_t n) {
+    DrawdownStatistics statistics;
+    analyzeBatch(returns, n, 1, 1, nullptr, &statistics);
+    return statistics.maxDrawdown;
+}
+
+DrawdownEngine::DrawdownStatistics DrawdownEngine::analyze(const double* returns, size_t n, double* drawdowns) {
+    DrawdownStatistics statistics;
+    analyzeBatch(returns, n, 1, 1, drawdowns, &statistics);
+    return statistics;
+}
+
+DrawdownEngine::DrawdownStatistics DrawdownEngine::analyze(const std::vector<double>& returns,
+                                                           std::vector<double>* drawdowns) {
+    if (drawdowns) drawdowns->resize(returns.size());
+    return analyze(returns.data(), returns.size(), drawdowns ? drawdowns->data() : nullptr);
+}
+
+std::vector<DrawdownEngine::DrawdownStatistics> DrawdownEngine::analyze(const Matrix& returns, Matrix* drawdowns) {
+    std::vector<DrawdownStatistics> statistics(returns.columns());
+    if (drawdowns) *drawdowns = Matrix(returns.rows(), returns.columns());
+    if (returns.columns() == 0) return statistics;
+    analyzeBatch(returns.begin(), returns.rows(), returns.columns(), returns.columns(),
+                 drawdowns ? drawdowns->begin() : nullptr, statistics.data());
+    return statistics;
+}
+
+std::vector<double> DrawdownEngine::rollingMaxDrawdown(const double* returns, size_t n, size_t window,
+                                                       size_t stride) {
+    if (window == 0 || window > n) {
+        throw std::runtime_error("DrawdownEngine: rolling window must be between 1 and the series length");
+    }
+
+    // Ring buffers of row indices; each deque holds at most `window` rows
+    std::vector<double> wealth(n), drawdown(n);
+    std::vector<size_t> peaks(window), troughs(window);
+    size_t peakHead = 0, peakSize = 0;
+    size_t troughHead = 0, troughSize = 0;
+    auto at = [window](size_t head, size_t k) { return (head + k) % window; };
+
+    std::vector<double> result(n - window + 1);
+    double value = 1.0;
+    for (size_t t = 0; t < n; ++t) {
+        double r = returns[t * stride];
+        value *= 1.0 + (r == r ? r : 0.0);
+        wealth[t] = value;
+
+        // Trailing peak: decreasing wealth from front to back
+        if (peakSize && peaks[peakHead] + window <= t) {
+            peakHead = at(peakHead, 1);
+            --peakSize;
+        }
+        while (peakSize && wealth[peaks[at(peakHead, peakSize - 1)]] <= value) --peakSize;
+        peaks[at(peakHead, peakSize++)] = t;
+        drawdown[t] = 1.0 - value / wealth[peaks[peakHead]];
+
+        // Trailing maximum of that drawdown
+        if (troughSize && troughs[troughHead] + window <= t) {
+            troughHead = at(troughHead, 1);
+            --troughSize;
+        }
+        while (troughSize && drawdown[troughs[at(troughHead, troughSize - 1)]] <= drawdown[t]) --troughSize;
+        troughs[at(troughHead, troughSize++)] = t;
+
+        if (t + 1 >= window) {
+            result[t + 1 - window] = drawdown[troughs[troughHead]];
+        }
+    }
+    return result;
+}
+
+Matrix DrawdownEngine::rollingMaxDrawdown(const Matrix& returns, size_t window) {
+    if (window == 0 || window > returns.rows()) {
+        throw std::runtime_error("DrawdownEngine: rolling window must be between 1 and the series length");
+    }
+    Matrix result(returns.rows() - window + 1, returns.columns());
+    for (Size j = 0; j < returns.columns(); ++j) {
+        std::vector<double> column = rollingMaxDrawdown(returns.begin() + j, returns.rows(), window,
+                                                        returns.columns());
+        for (Size k = 0; k < column.size(); ++k) {
+            result[k][j] = column[k];
+        }
+    }
+    return result;
+}
+
+// Private helper methods
+void DrawdownEngine::analyzeBatch(const double* returns, size_t n, size_t count, size_t stride,
+                                  double* drawdowns, DrawdownStatistics* statistics) {
+    std::vector<double> value(count, 1.0), peak(count, 1.0), maxDrawdown(count, 0.0);
+    std::vector<double> recoveryLevel(count, 0.0);
+    std::vector<size_t> peakIndex(count, 0), longest(count, 0);
+
+    for (size_t t = 0; t < n; ++t) {
+        const double* row = returns + t * stride;
+        double* out = drawdowns ? drawdowns + t * stride : nullptr;
+        size_t i = t + 1;
+
+        for (size_t p = 0; p < count; ++p) {
+            double r = row[p];
+            double v = value[p] * (1.0 + (r == r ? r : 0.0));
+            value[p] = v;
+
+            // A new (or regained) peak ends the current underwater stretch
+            if (v >= peak[p]) {
+                longest[p] = std::max(longest[p], i - peakIndex[p] - 1);
+                peak[p] = v;
+                peakIndex[p] = i;
+            }
+            double dd = 1.0 - v / peak[p];
+            if (out) out[p] = dd;
+
+            DrawdownStatistics& s = statistics[p];
+            if (dd > maxDrawdown[p]) {
+                maxDrawdown[p] = dd;
+                s.peakIndex = peakIndex[p];
+                s.troughIndex = i;
+                s.recoveryIndex = npos;
+                recoveryLevel[p] = peak[p];
+            } else if (s.recoveryIndex == npos && maxDrawdown[p] > 0.0 && v >= recoveryLevel[p]) {
+                s.recoveryIndex = i;
+            }
+        }
+    }
+
+    for (size_t p = 0; p < count; ++p) {
+        DrawdownStatistics& s = statistics[p];
+        s.maxDrawdown = maxDrawdown[p];
+        if (s.maxDrawdown == 0.0) {
+            s.recoveryIndex = 0;    // never below the starting value's peak
+        }
+        s.drawdownDuration = s.troughIndex - s.peakIndex;
+        s.recoveryDuration = s.recoveryIndex == npos ? npos : s.recoveryIndex - s.troughIndex;
+        s.longestUnderwater = std::max(longest[p], n - peakIndex[p]);
+        s.currentDrawdown = 1.0 - value[p] / peak[p];
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <vector>
+
+using namespace QuantLib;
+
+// Single implementation of drawdown analytics for every consumer
+// (RiskMetrics, StressTesting, DataManager, ParameterSweep).
+//
+// One O(T) pass over compounded wealth yields the drawdown series, the max
+// drawdown with its peak, trough and recovery, and the longest underwater
+// stretch. Indices refer to the wealth path: 0 is the starting value and
+// t + 1 the value after return row t. Durations are counted in rows.
+// Missing (NaN) returns count as zero, as in IncrementalStatistics.
+//
+// The batch form takes a T x P matrix (row t holds the returns of P
+// portfolios or assets) and keeps its running state in per-portfolio
+// arrays, so each time step is one contiguous sweep across all portfolios.
+// Single series go through the same kernel with P = 1.
+class DrawdownEngine {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct DrawdownStatistics {
+        double maxDrawdown{0.0};        // positive fraction of the peak
+        size_t peakIndex{0};            // peak preceding the max drawdown
+        size_t troughIndex{0};
+        size_t recoveryIndex{npos};     // first return to the peak, npos if none
+        size_t drawdownDuration{0};     // peak to trough
+        size_t recoveryDuration{npos};  // trough to recovery, npos if none
+        size_t longestUnderwater{0};    // most consecutive rows below a peak
+        double currentDrawdown{0.0};    // at the last row
+
+        DrawdownStatistics() = default;
+    };
+
+    // Max drawdown only
+    static double maxDrawdown(const double* returns, size_t n);
+    static double maxDrawdown(const std::vector<double>& returns) {
+        return maxDrawdown(returns.data(), returns.size());
+    }
+
+    // Full statistics; drawdowns (length n) receives the series if given
+    static DrawdownStatistics analyze(const double* returns, size_t n, double* drawdowns = nullptr);
+    static DrawdownStatistics analyze(const std::vector<double>& returns,
+                                      std::vector<double>* drawdowns = nullptr);
+
+    // Every column of a T x P matrix at once; drawdowns (T x P) receives the
+    // series if given
+    static std::vector<DrawdownStatistics> analyze(const Matrix& returns, Matrix* drawdowns = nullptr);
+
+    // Drawdown against the trailing `window`-row peak, then its trailing
+    // `window`-row maximum; both extrema come from monotonic deques, so the
+    // cost is O(T) for any window. Entry k covers the window ending at row
+    // k + window - 1 (n - window + 1 entries). An early row in the window
+    // measures from its own trailing peak, which may precede the window, so
+    // this is the usual rolling definition rather than the max drawdown of
+    // the window taken in isolation.
+    static std::vector<double> rollingMaxDrawdown(const double* returns, size_t n, size_t window,
+                                                  size_t stride = 1);
+    static Matrix rollingMaxDrawdown(const Matrix& returns, size_t window);
+
+private:
+    // returns[t * stride + p] for t < n, p < count
+    static void analyzeBatch(const double* returns, size_t n, size_t count, size_t stride,
+                             double* drawdowns, DrawdownStatistics* statistics);
+};
@@ -0,0 +1,119 @@
+#include "IncrementalEvaluator.hpp"
+#include "MatrixOperations.hpp"
+#include <cmath>
+#include <algorithm>
+
+IncrementalEvaluator::IncrementalEvaluator(
+    const SymmetricMatrix& covariance,
+    const std::vector<double>& expectedReturns,
+    TransactionCostModel* costModel,
+    double portfolioValue)
+    : covariance_(covariance)
+    , expectedReturns_(expectedReturns)
+    , costModel_(costModel)
+    , portfolioValue_(portfolioValue) {
+
+    if (covariance_.size() != expectedReturns_.size()) {
+        throw std::runtime_error("IncrementalEvaluator: dimension mismatch");
+    }
+}
+
+void IncrementalEvaluator::reset(const Matrix& weights, const Matrix& referenceWeights) {
+    try {
+        Size n = covariance_.size();
+        if (weights.rows() != n || referenceWeights.rows() != n) {
+            throw std::runtime_error("Weight vector size does not match covariance");
+        }
+
+        weights_.resize(n);
+        referenceWeights_.resize(n);
+        for (Size i = 0; i < n; ++i) {
+            weights_[i] = weights[i][0];
+            referenceWeights_[i] = referenceWeights[i][0];
+        }
+        recompute();
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in IncrementalEvaluator::reset: " + std::string(e.what()));
+    }
+}
+
+IncrementalEvaluator::Evaluation IncrementalEvaluator::evaluateMove(const Move& move) {
+    Evaluation candidate = current_;
+
+    for (Size m = 0; m < move.assets.size(); ++m) {
+        Size i = move.assets[m];
+        double newWeight = weights_[i] + move.deltas[m];
+        candidate.expectedReturn += expectedReturns_[i] * move.deltas[m];
+        candidate.tradingCost += assetCost(i, newWeight) - assetCosts_[i];
+    }
+
+    candidate.variance += varianceChange(move);
+    candidate.risk = std::sqrt(std::max(candidate.variance, 0.0));
+    return candidate;
+}
+
+void IncrementalEvaluator::commitMove(const Move& move) {
+    Evaluation updated = evaluateMove(move);
+
+    for (Size m = 0; m < move.assets.size(); ++m) {
+        Size i = move.assets[m];
+        double delta = move.deltas[m];
+        weights_[i] += delta;
+        assetCosts_[i] = assetCost(i, weights_[i]);
+
+        MatrixOperations::addColumn(covariance_, i, delta, sigmaW_.data());
+    }
+    current_ = updated;
+
+    if (++commitsSinceResync_ >= resyncInterval_) {
+        recompute();
+    }
+}
+
+Matrix IncrementalEvaluator::getWeightsMatrix() const {
+    Matrix weights(weights_.size(), 1);
+    for (Size i = 0; i < weights_.size(); ++i) {
+        weights[i][0] = weights_[i];
+    }
+    return weights;
+}
+
+// Private helper methods
+void IncrementalEvaluator::recompute() {
+    Size n = weights_.size();
+    sigmaW_.resize(n);
+    assetCosts_.resize(n);
+    current_ = Evaluation();
+
+    MatrixOperations::symv(covariance_, weights_.data(), sigmaW_.data());
+    current_.variance = MatrixOperations::dot(weights_.data(), sigmaW_.data(), n);
+    current_.expectedReturn = MatrixOperations::dot(expectedReturns_.data(), weights_.data(), n);
+    for (Size i = 0; i < n; ++i) {
+        assetCosts_[i] = assetCost(i, weights_[i]);
+        current_.tradingCost += assetCosts_[i];
+    }
+
+    current_.risk = std::sqrt(std::max(current_.variance, 0.0));
+    commitsSinceResync_ = 0;
+}
+
+double IncrementalEvaluator::assetCost(Size asset, double weight) {
+    if (!costModel_) return 0.0;
+    double tradeSize = std::abs(weight - referenceWeights_[asset]) * portfolioValue_;
+    return costModel_->calculateAssetCost(static_cast<int>(asset), tradeSize);
+}
+
+double IncrementalEvaluator::varianceChange(const Move& move) const {
+    // (w+d)'Sigma(w+d) - w'Sigma w = 2 d'(Sigma w) + d'Sigma d, with d sparse
+    double change = 0.0;
+    for (Size a = 0; a < move.assets.size(); ++a) {
+        Size i = move.assets[a];
+        double di = move.deltas[a];
+        change += 2.0 * di * sigmaW_[i];
+        for (Size b = 0; b < move.assets.size(); ++b) {
+            change += di * covariance_(i, move.assets[b]) * move.deltas[b];
+        }
+    }
+    return change;
+}
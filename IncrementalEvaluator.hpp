@@ -0,0 +1,76 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <vector>
+#include <stdexcept>
+#include "TransactionCostModel.hpp"
+#include "SymmetricMatrix.hpp"
+
+using namespace QuantLib;
+
+// Caches Sigma w, w'Sigma w, mu'w and per-asset trading costs for the
+// current point of a search. A sparse move touching k assets is priced in
+// O(k^2) for risk and O(k) for return and cost; committing it updates
+// Sigma w in O(k N).
+class IncrementalEvaluator {
+public:
+    struct Evaluation {
+        double expectedReturn{0.0};
+        double variance{0.0};
+        double risk{0.0};
+        double tradingCost{0.0};
+
+        Evaluation() = default;
+    };
+
+    // A move adds deltas[m] to the weight of assets[m]; assets must be distinct
+    struct Move {
+        std::vector<Size> assets;
+        std::vector<double> deltas;
+
+        void clear() { assets.clear(); deltas.clear(); }
+        void add(Size asset, double delta) {
+            assets.push_back(asset);
+            deltas.push_back(delta);
+        }
+    };
+
+    // covariance and costModel must outlive the evaluator
+    IncrementalEvaluator(const SymmetricMatrix& covariance,
+                         const std::vector<double>& expectedReturns,
+                         TransactionCostModel* costModel = nullptr,
+                         double portfolioValue = 0.0);
+
+    // Full O(N^2) recomputation at a new point; referenceWeights are the
+    // holdings trading costs are measured against
+    void reset(const Matrix& weights, const Matrix& referenceWeights);
+
+    Evaluation current() const { return current_; }
+    Evaluation evaluateMove(const Move& move);
+    void commitMove(const Move& move);
+
+    const std::vector<double>& getWeights() const { return weights_; }
+    const std::vector<double>& getSigmaW() const { return sigmaW_; }     // Sigma w at the current point
+    Matrix getWeightsMatrix() const;
+
+    // Full recomputation every resyncInterval commits bounds round-off drift
+    void setResyncInterval(int commits) { resyncInterval_ = commits; }
+
+private:
+    const SymmetricMatrix& covariance_;
+    std::vector<double> expectedReturns_;
+    TransactionCostModel* costModel_;
+    double portfolioValue_;
+
+    std::vector<double> weights_;
+    std::vector<double> referenceWeights_;
+    std::vector<double> sigmaW_;
+    std::vector<double> assetCosts_;
+    Evaluation current_;
+    int commitsSinceResync_{0};
+    int resyncInterval_{1000};
+
+    // Helper methods
+    void recompute();
+    double assetCost(Size asset, double weight);
+    double varianceChange(const Move& move) const;
+};
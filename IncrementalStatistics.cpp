@@ -0,0 +1,110 @@
+#include "IncrementalStatistics.hpp"
+#include "MatrixOperations.hpp"
+#include <algorithm>
+#include <cmath>
+
+IncrementalStatistics::IncrementalStatistics(Size numAssets, Size windowSize, double ewmaLambda)
+    : numAssets_(numAssets)
+    , windowSize_(windowSize)
+    , lambda_(ewmaLambda)
+    , window_(numAssets * windowSize, 0.0)
+    , sum_(numAssets, 0.0)
+    , crossProducts_(numAssets)
+    , ewmaCovariance_(numAssets)
+    , wealth_(numAssets, 1.0)
+    , peaks_(numAssets, 1.0)
+    , maxDrawdowns_(numAssets, 0.0) {
+
+    if (windowSize_ < 2) {
+        throw std::runtime_error("IncrementalStatistics: window must hold at least two rows");
+    }
+    if (lambda_ <= 0.0 || lambda_ >= 1.0) {
+        throw std::runtime_error("IncrementalStatistics: EWMA lambda must be in (0, 1)");
+    }
+}
+
+void IncrementalStatistics::update(const Real* returns) {
+    Size n = numAssets_;
+
+    // Rolling window: retire the oldest row once full, then add the new one
+    Real* slot = window_.data() + head_ * n;
+    if (count_ == windowSize_) {
+        addToSums(slot, -1.0);
+    } else {
+        ++count_;
+    }
+    // Missing observations (NaN) are taken as a zero return
+    for (Size i = 0; i < n; ++i) {
+        slot[i] = std::isnan(returns[i]) ? 0.0 : returns[i];
+    }
+    addToSums(slot, 1.0);
+    head_ = (head_ + 1) % windowSize_;
+    const Real* row = slot;
+
+    // EWMA covariance (zero-mean, as in RiskMetrics::calculateExponentialCovariance)
+    double decay = observations_ == 0 ? 0.0 : lambda_;
+    for (Size i = 0; i < n; ++i) {
+        Real* ewmaRow = ewmaCovariance_.row(i);
+        for (Size k = 0; k < n - i; ++k) {
+            ewmaRow[k] *= decay;
+        }
+        MatrixOperations::axpy((1.0 - decay) * row[i], row + i, ewmaRow, n - i);
+    }
+
+    // Drawdown peaks
+    for (Size i = 0; i < n; ++i) {
+        wealth_[i] *= (1.0 + row[i]);
+        peaks_[i] = std::max(peaks_[i], wealth_[i]);
+        maxDrawdowns_[i] = std::max(maxDrawdowns_[i], 1.0 - wealth_[i] / peaks_[i]);
+    }
+
+    ++observations_;
+    if (++updatesSinceResync_ >= resyncInterval_) {
+        resync();
+    }
+}
+
+std::vector<double> IncrementalStatistics::mean() const {
+    std::vector<double> result(sum_);
+    for (double& value : result) {
+        value /= std::max<Size>(count_, 1);
+    }
+    return result;
+}
+
+SymmetricMatrix IncrementalStatistics::covariance() const {
+    if (count_ < 2) {
+        throw std::runtime_error("IncrementalStatistics: not enough observations for covariance");
+    }
+
+    // (sum x x' - sum x sum x' / n) / (n - 1)
+    Size n = numAssets_;
+    double count = static_cast<double>(count_);
+    SymmetricMatrix result(crossProducts_);
+    for (Size i = 0; i < n; ++i) {
+        Real* row = result.row(i);
+        MatrixOperations::axpy(-sum_[i] / count, sum_.data() + i, row, n - i);
+        for (Size k = 0; k < n - i; ++k) {
+            row[k] /= (count - 1.0);
+        }
+    }
+    return result;
+}
+
+// Private helper methods
+void IncrementalStatistics::addToSums(const Real* row, double sign) {
+    Size n = numAssets_;
+    MatrixOperations::axpy(sign, row, sum_.data(), n);
+    for (Size i = 0; i < n; ++i) {
+        MatrixOperations::axpy(sign * row[i], row + i, crossProducts_.row(i), n - i);
+    }
+}
+
+void IncrementalStatistics::resync() {
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+    std::fill(crossProducts_.begin(), crossProducts_.end(), 0.0);
+    for (Size r = 0; r < count_; ++r) {
+        addToSums(window_.data() + r * numAssets_, 1.0);
+    }
+    updatesSinceResync_ = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <vector>
+#include <stdexcept>
+#include "SymmetricMatrix.hpp"
+
+using namespace QuantLib;
+
+// Streaming statistics over a return series, one row (N asset returns) at
+// a time. Each update costs O(N^2) regardless of how much history has been
+// seen:
+//  - rolling-window mean and covariance from running sums and packed
+//    cross-products (the oldest row is subtracted once the window is full)
+//  - EWMA covariance  C <- lambda C + (1 - lambda) x x'
+//  - per-asset cumulative wealth, running peak and max drawdown
+// Missing observations (NaN) enter every estimate as a zero return.
+class IncrementalStatistics {
+public:
+    IncrementalStatistics() : IncrementalStatistics(0, 252) {}
+    IncrementalStatistics(Size numAssets, Size windowSize, double ewmaLambda = 0.94);
+
+    void update(const Real* returns);
+    void update(const std::vector<double>& returns) { update(returns.data()); }
+
+    Size numAssets() const { return numAssets_; }
+    Size windowSize() const { return windowSize_; }
+    Size windowCount() const { return count_; }
+    Size observations() const { return observations_; }
+
+    // Rolling-window estimates (sample covariance, T - 1 denominator)
+    std::vector<double> mean() const;
+    SymmetricMatrix covariance() const;
+    const SymmetricMatrix& ewmaCovariance() const { return ewmaCovariance_; }
+
+    // Drawdown state per asset
+    const std::vector<double>& wealth() const { return wealth_; }
+    const std::vector<double>& peaks() const { return peaks_; }
+    const std::vector<double>& maxDrawdowns() const { return maxDrawdowns_; }
+
+    // Full recomputation of the window sums every resyncInterval updates
+    // keeps the add/subtract round-off from accumulating
+    void setResyncInterval(Size updates) { resyncInterval_ = updates; }
+
+private:
+    Size numAssets_;
+    Size windowSize_;
+    double lambda_;
+
+    // Ring buffer holding the rows currently in the window
+    std::vector<double> window_;
+    Size head_{0};
+    Size count_{0};
+    Size observations_{0};
+
+    std::vector<double> sum_;
+    SymmetricMatrix crossProducts_;
+    SymmetricMatrix ewmaCovariance_;
+
+    std::vector<double> wealth_;
+    std::vector<double> peaks_;
+    std::vector<double> maxDrawdowns_;
+
+    Size updatesSinceResync_{0};
+    Size resyncInterval_{10000};
+
+    void addToSums(const Real* row, double sign);
+    void resync();
+};
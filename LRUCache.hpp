@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Fast 64-bit hashing of numeric buffers for memoization keys. Words are
+// mixed four lanes at a time (multiply-xorshift), then finalized with the
+// splitmix64 avalanche, so hashing a return window is one streaming read.
+namespace MemoHash {
+
+    inline uint64_t mix(uint64_t h) {
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    inline uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+    }
+
+    inline uint64_t word(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline uint64_t doubles(const double* data, size_t n, uint64_t seed = 0) {
+        const uint64_t k = 0x9e3779b97f4a7c15ULL;
+        uint64_t h0 = seed ^ n, h1 = h0 + k, h2 = h1 + k, h3 = h2 + k;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            h0 = (h0 ^ word(data[i])) * k;
+            h1 = (h1 ^ word(data[i + 1])) * k;
+            h2 = (h2 ^ word(data[i + 2])) * k;
+            h3 = (h3 ^ word(data[i + 3])) * k;
+        }
+        for (; i < n; ++i) {
+            h0 = (h0 ^ word(data[i])) * k;
+        }
+        return combine(combine(mix(h0), mix(h1)), combine(mix(h2), mix(h3)));
+    }
+}
+
+// Bounded least-recently-used map. find() refreshes an entry; insert()
+// evicts the oldest entry once capacity is reached.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+public:
+    struct Statistics {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+        size_t size{0};
+        size_t capacity{0};
+    };
+
+    explicit LRUCache(size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    const Value* find(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    void insert(const Key& key, Value value) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (entries_.size() >= capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            ++evictions_;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    Statistics statistics() const {
+        Statistics stats;
+        stats.hits = hits_;
+        stats.misses = misses_;
+        stats.evictions = evictions_;
+        stats.size = entries_.size();
+        stats.capacity = capacity_;
+        return stats;
+    }
+
+private:
+    size_t capacity_;
+    std::list<std::pair<Key, Value>> entries_;   // most recent first
+    std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator, Hash> index_;
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+    uint64_t evictions_{0};
+};
@@ -0,0 +1,198 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include "SymmetricMatrix.hpp"
+
+using namespace QuantLib;
+
+// Allocation-free linear algebra kernels over contiguous spans (pointer +
+// length). QuantLib's Matrix is dense row-major, so an N x 1 weight vector
+// and every covariance row are contiguous and can be passed directly.
+//
+// Symmetric kernels (symv, quadForm) read only the upper triangle, which
+// halves covariance memory traffic. Reductions use four independent
+// accumulators so the compiler can vectorize them without -ffast-math.
+namespace MatrixOperations {
+
+    // x'y
+    inline double dot(const Real* x, const Real* y, Size n) {
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        Size i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += x[i] * y[i];
+            s1 += x[i + 1] * y[i + 1];
+            s2 += x[i + 2] * y[i + 2];
+            s3 += x[i + 3] * y[i + 3];
+        }
+        for (; i < n; ++i) {
+            s0 += x[i] * y[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    // y += alpha x
+    inline void axpy(double alpha, const Real* x, Real* y, Size n) {
+        for (Size i = 0; i < n; ++i) {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    // y = A x for a general rows x columns matrix
+    inline void gemv(const Matrix& A, const Real* x, Real* y) {
+        Size cols = A.columns();
+        for (Size i = 0; i < A.rows(); ++i) {
+            y[i] = dot(A[i], x, cols);
+        }
+    }
+
+    // y = A' x, accumulated row by row so A is streamed once
+    inline void gemvTransposed(const Matrix& A, const Real* x, Real* y) {
+        Size cols = A.columns();
+        for (Size j = 0; j < cols; ++j) {
+            y[j] = 0.0;
+        }
+        for (Size i = 0; i < A.rows(); ++i) {
+            axpy(x[i], A[i], y, cols);
+        }
+    }
+
+    // y = S x for symmetric S, reading the upper triangle only
+    inline void symv(const Matrix& S, const Real* x, Real* y) {
+        Size n = S.rows();
+        for (Size i = 0; i < n; ++i) {
+            y[i] = 0.0;
+        }
+        for (Size i = 0; i < n; ++i) {
+            const Real* row = S[i];
+            Size tail = n - i - 1;
+            y[i] += row[i] * x[i] + dot(row + i + 1, x + i + 1, tail);
+            axpy(x[i], row + i + 1, y + i + 1, tail);
+        }
+    }
+
+    // x'S x for symmetric S, reading the upper triangle only
+    inline double quadForm(const Matrix& S, const Real* x) {
+        Size n = S.rows();
+        double total = 0.0;
+        for (Size i = 0; i < n; ++i) {
+            const Real* row = S[i];
+            total += x[i] * (row[i] * x[i] + 2.0 * dot(row + i + 1, x + i + 1, n - i - 1));
+        }
+        return total;
+    }
+
+    // Packed symmetric variants; SymmetricMatrix rows already start at the
+    // diagonal, so these are the dense upper-triangle loops without the skip
+    inline void symv(const SymmetricMatrix& S, const Real* x, Real* y) {
+        Size n = S.size();
+        for (Size i = 0; i < n; ++i) {
+            y[i] = 0.0;
+        }
+        for (Size i = 0; i < n; ++i) {
+            const Real* row = S.row(i);
+            Size tail = n - i - 1;
+            y[i] += row[0] * x[i] + dot(row + 1, x + i + 1, tail);
+            axpy(x[i], row + 1, y + i + 1, tail);
+        }
+    }
+
+    inline double quadForm(const SymmetricMatrix& S, const Real* x) {
+        Size n = S.size();
+        double total = 0.0;
+        for (Size i = 0; i < n; ++i) {
+            const Real* row = S.row(i);
+            total += x[i] * (row[0] * x[i] + 2.0 * dot(row + 1, x + i + 1, n - i - 1));
+        }
+        return total;
+    }
+
+    // y += alpha S e_j (column j), for incremental Sigma w updates
+    inline void addColumn(const SymmetricMatrix& S, Size j, double alpha, Real* y) {
+        Size n = S.size();
+        for (Size k = 0; k < j; ++k) {
+            y[k] += alpha * S.row(k)[j - k];
+        }
+        axpy(alpha, S.row(j), y + j, n - j);
+    }
+
+    // Sample covariance (T - 1 denominator) of a T x N observation panel,
+    // accumulated as rank-one updates of the packed upper triangle
+    inline SymmetricMatrix sampleCovariance(const Matrix& observations) {
+        Size numObs = observations.rows();
+        Size n = observations.columns();
+        if (numObs < 2) {
+            throw std::runtime_error("sampleCovariance: not enough observations");
+        }
+
+        std::vector<double> mean(n, 0.0);
+        for (Size t = 0; t < numObs; ++t) {
+            axpy(1.0, observations[t], mean.data(), n);
+        }
+        for (double& m : mean) {
+            m /= numObs;
+        }
+
+        SymmetricMatrix covariance(n);
+        std::vector<double> centered(n);
+        for (Size t = 0; t < numObs; ++t) {
+            for (Size j = 0; j < n; ++j) {
+                centered[j] = observations[t][j] - mean[j];
+            }
+            for (Size i = 0; i < n; ++i) {
+                axpy(centered[i], centered.data() + i, covariance.row(i), n - i);
+            }
+        }
+        for (Real& value : covariance) {
+            value /= (numObs - 1);
+        }
+        return covariance;
+    }
+
+    inline SymmetricMatrix correlationFromCovariance(const SymmetricMatrix& covariance) {
+        Size n = covariance.size();
+        std::vector<double> invSigma(n);
+        for (Size i = 0; i < n; ++i) {
+            invSigma[i] = 1.0 / std::sqrt(covariance.row(i)[0]);
+        }
+
+        SymmetricMatrix correlation(covariance);
+        for (Size i = 0; i < n; ++i) {
+            Real* row = correlation.row(i);
+            for (Size j = i; j < n; ++j) {
+                row[j - i] *= invSigma[i] * invSigma[j];
+            }
+        }
+        return correlation;
+    }
+
+    // Convenience overloads for N x 1 weight matrices
+    inline double quadForm(const Matrix& S, const Matrix& w) {
+        if (S.rows() != S.columns() || w.rows() != S.rows()) {
+            throw std::runtime_error("quadForm: dimension mismatch");
+        }
+        return quadForm(S, w.begin());
+    }
+
+    inline void symv(const Matrix& S, const Matrix& w, Matrix& y) {
+        if (S.rows() != S.columns() || w.rows() != S.rows() || y.rows() != S.rows()) {
+            throw std::runtime_error("symv: dimension mismatch");
+        }
+        symv(S, w.begin(), y.begin());
+    }
+
+    inline double quadForm(const SymmetricMatrix& S, const Matrix& w) {
+        if (w.rows() != S.size()) {
+            throw std::runtime_error("quadForm: dimension mismatch");
+        }
+        return quadForm(S, w.begin());
+    }
+
+    inline void symv(const SymmetricMatrix& S, const Matrix& w, Matrix& y) {
+        if (w.rows() != S.size() || y.rows() != S.size()) {
+            throw std::runtime_error("symv: dimension mismatch");
+        }
+        symv(S, w.begin(), y.begin());
+    }
+}
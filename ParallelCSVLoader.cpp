@@ -0,0 +1,249 @@
+#include "ParallelCSVLoader.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+size_t ParallelCSVLoader::Table::columnIndex(const std::string& name) const {
+    auto it = std::find(header.begin(), header.end(), name);
+    if (it == header.end()) {
+        throw std::runtime_error("Unknown column: " + name);
+    }
+    return static_cast<size_t>(it - header.begin());
+}
+
+ParallelCSVLoader::ParallelCSVLoader(unsigned int numThreads,
+                                     size_t minChunkBytes,
+                                     char separator)
+    : numThreads_(numThreads ? numThreads : std::max(1u, std::thread::hardware_concurrency()))
+    , minChunkBytes_(std::max<size_t>(minChunkBytes, 1))
+    , separator_(separator) {}
+
+ParallelCSVLoader::Table ParallelCSVLoader::load(
+    const std::string& filename,
+    size_t dateColumn) const {
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + filename);
+    }
+
+    // One bulk read; all parsing works on this buffer
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&content[0], content.size());
+
+    try {
+        return parse(content, dateColumn);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error loading " + filename + ": " + e.what());
+    }
+}
+
+ParallelCSVLoader::Table ParallelCSVLoader::parse(
+    const std::string& content,
+    size_t dateColumn) const {
+
+    Table table;
+
+    // Header
+    size_t headerEnd = content.find('\n');
+    if (headerEnd == std::string::npos) headerEnd = content.size();
+    size_t fieldStart = 0;
+    for (size_t i = 0; i <= headerEnd; ++i) {
+        if (i == headerEnd || content[i] == separator_) {
+            size_t fieldEnd = i;
+            if (fieldEnd > fieldStart && content[fieldEnd - 1] == '\r') --fieldEnd;
+            table.header.push_back(content.substr(fieldStart, fieldEnd - fieldStart));
+            fieldStart = i + 1;
+        }
+    }
+    if (dateColumn >= table.header.size()) {
+        throw std::runtime_error("Date column out of range");
+    }
+
+    // Rows end at the last newline; a partially written last line is left
+    // for the next read
+    size_t bodyStart = std::min(headerEnd + 1, content.size());
+    size_t lastNewline = content.rfind('\n');
+    size_t bodyEnd = lastNewline == std::string::npos ? bodyStart : std::max(bodyStart, lastNewline + 1);
+    table.bytesRead = bodyEnd;
+    std::vector<Chunk> chunks = splitChunks(content, bodyStart, bodyEnd);
+
+    // Pass 1: rows per chunk, so every chunk knows where its rows land
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k < chunks.size(); ++k) {
+        workers.emplace_back([&chunks, &content, k]() {
+            chunks[k].rowCount = countRows(content, chunks[k].begin, chunks[k].end);
+        });
+    }
+    if (!chunks.empty()) {
+        chunks[0].rowCount = countRows(content, chunks[0].begin, chunks[0].end);
+    }
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+
+    size_t totalRows = 0;
+    for (auto& chunk : chunks) {
+        chunk.firstRow = totalRows;
+        totalRows += chunk.rowCount;
+    }
+
+    // Preallocate every column slot
+    table.dates.resize(totalRows);
+    table.columns.resize(table.header.size());
+    for (size_t c = 0; c < table.columns.size(); ++c) {
+        if (c != dateColumn) {
+            table.columns[c].assign(totalRows, std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+
+    // Pass 2: parse chunks into their disjoint row ranges
+    std::vector<std::exception_ptr> errors(chunks.size());
+    auto parseTask = [&](size_t k) {
+        try {
+            parseChunk(content, chunks[k], dateColumn, table);
+        }
+        catch (...) {
+            errors[k] = std::current_exception();
+        }
+    };
+    for (size_t k = 1; k < chunks.size(); ++k) {
+        workers.emplace_back(parseTask, k);
+    }
+    if (!chunks.empty()) parseTask(0);
+    for (auto& worker : workers) worker.join();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    return table;
+}
+
+boost::gregorian::date ParallelCSVLoader::parseDate(const char* begin, const char* end) {
+    while (end > begin && (end[-1] == '\r' || end[-1] == ' ')) --end;
+
+    auto readInt = [](const char*& p, const char* stop, int& value) {
+        auto result = std::from_chars(p, stop, value);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    };
+
+    // Fast paths: YYYY-MM-DD and M/D/YYYY
+    int a = 0, b = 0, c = 0;
+    const char* p = begin;
+    if (readInt(p, end, a) && p < end && (*p == '-' || *p == '/')) {
+        char sep = *p++;
+        if (readInt(p, end, b) && p < end && *p == sep) {
+            ++p;
+            if (readInt(p, end, c) && p == end) {
+                if (sep == '-' && a > 31) return boost::gregorian::date(a, b, c);
+                if (sep == '/' && c > 31) return boost::gregorian::date(c, a, b);
+            }
+        }
+    }
+
+    return boost::gregorian::from_string(std::string(begin, end));
+}
+
+double ParallelCSVLoader::parseNumber(const char* begin, const char* end) {
+    while (begin < end && *begin == ' ') ++begin;
+    while (end > begin && (end[-1] == '\r' || end[-1] == ' ')) --end;
+    if (begin == end) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (*begin == '+') ++begin;
+
+    double value = 0.0;
+    auto result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+        throw std::runtime_error("Invalid number: " + std::string(begin, end));
+    }
+    return value;
+}
+
+// Private helper methods
+std::vector<ParallelCSVLoader::Chunk> ParallelCSVLoader::splitChunks(
+    const std::string& content,
+    size_t bodyStart,
+    size_t bodyEnd) const {
+
+    size_t bodyBytes = bodyEnd - bodyStart;
+    size_t numChunks = std::max<size_t>(1, std::min<size_t>(numThreads_, bodyBytes / minChunkBytes_));
+
+    std::vector<Chunk> chunks;
+    size_t begin = bodyStart;
+    for (size_t k = 1; k <= numChunks && begin < bodyEnd; ++k) {
+        size_t end = bodyEnd;
+        if (k < numChunks) {
+            // Advance the nominal split point to the next line start
+            size_t target = std::max(begin, bodyStart + k * bodyBytes / numChunks);
+            size_t newline = content.find('\n', target);
+            end = (newline == std::string::npos || newline >= bodyEnd) ? bodyEnd : newline + 1;
+        }
+        chunks.push_back(Chunk{begin, end, 0, 0});
+        begin = end;
+    }
+    return chunks;
+}
+
+size_t ParallelCSVLoader::countRows(const std::string& content, size_t begin, size_t end) {
+    size_t rows = 0;
+    size_t lineStart = begin;
+    for (size_t i = begin; i < end; ++i) {
+        if (content[i] == '\n') {
+            if (i > lineStart && !(i == lineStart + 1 && content[lineStart] == '\r')) ++rows;
+            lineStart = i + 1;
+        }
+    }
+    if (end > lineStart && !(end == lineStart + 1 && content[lineStart] == '\r')) ++rows;
+    return rows;
+}
+
+void ParallelCSVLoader::parseChunk(
+    const std::string& content,
+    const Chunk& chunk,
+    size_t dateColumn,
+    Table& table) const {
+
+    const char* data = content.data();
+    size_t numColumns = table.header.size();
+    size_t row = chunk.firstRow;
+    size_t lineStart = chunk.begin;
+
+    while (lineStart < chunk.end) {
+        size_t lineEnd = lineStart;
+        while (lineEnd < chunk.end && data[lineEnd] != '\n') ++lineEnd;
+
+        size_t contentEnd = lineEnd;
+        if (contentEnd > lineStart && data[contentEnd - 1] == '\r') --contentEnd;
+
+        if (contentEnd > lineStart) {
+            size_t column = 0;
+            size_t fieldStart = lineStart;
+            for (size_t i = lineStart; i <= contentEnd; ++i) {
+                if (i == contentEnd || data[i] == separator_) {
+                    if (column >= numColumns) {
+                        throw std::runtime_error("Too many fields in row " + std::to_string(row + 1));
+                    }
+                    if (column == dateColumn) {
+                        table.dates[row] = parseDate(data + fieldStart, data + i);
+                    } else {
+                        table.columns[column][row] = parseNumber(data + fieldStart, data + i);
+                    }
+                    ++column;
+                    fieldStart = i + 1;
+                }
+            }
+            // Fields missing at the end of the row stay NaN
+            ++row;
+        }
+        lineStart = lineEnd + 1;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <boost/date_time.hpp>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Multi-threaded loader for numeric CSV files with a leading date column.
+// The file is read once, split at newline boundaries into one chunk per
+// thread, and every chunk is parsed straight into preallocated column
+// arrays by column index. Chunks own disjoint row ranges, so the merge is
+// lock-free. Empty and missing trailing fields are stored as NaN.
+class ParallelCSVLoader {
+public:
+    struct Table {
+        std::vector<std::string> header;
+        std::vector<boost::gregorian::date> dates;
+        std::vector<std::vector<double>> columns;   // columns[c][row]; date column left empty
+        size_t bytesRead{0};                        // end of the last complete line; tail reads resume here
+
+        size_t rowCount() const { return dates.size(); }
+        size_t columnIndex(const std::string& name) const;
+    };
+
+    explicit ParallelCSVLoader(unsigned int numThreads = 0,
+                               size_t minChunkBytes = 1 << 20,
+                               char separator = ',');
+
+    Table load(const std::string& filename, size_t dateColumn = 0) const;
+    // Rows stop at the last newline; an unterminated last line is not parsed
+    Table parse(const std::string& content, size_t dateColumn = 0) const;
+
+    // Field parsers shared with the append/tail ingestion path
+    static boost::gregorian::date parseDate(const char* begin, const char* end);
+    static double parseNumber(const char* begin, const char* end);
+
+private:
+    unsigned int numThreads_;
+    size_t minChunkBytes_;
+    char separator_;
+
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        size_t firstRow;
+        size_t rowCount;
+    };
+
+    std::vector<Chunk> splitChunks(const std::string& content, size_t bodyStart, size_t bodyEnd) const;
+    static size_t countRows(const std::string& content, size_t begin, size_t end);
+    void parseChunk(const std::string& content, const Chunk& chunk,
+                    size_t dateColumn, Table& table) const;
+};
@@ -0,0 +1,269 @@
+#include "ParameterSweep.hpp"
+#include "AsyncWriter.hpp"
+#include "DrawdownEngine.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+
+std::vector<ParameterSweep::Config> ParameterSweep::Grid::expand() const {
+    Config defaults;
+    std::vector<int> windows = windowSizes.empty() ? std::vector<int>{defaults.windowSize} : windowSizes;
+    std::vector<double> aversions = riskAversions.empty() ? std::vector<double>{defaults.riskAversion} : riskAversions;
+    std::vector<RiskConstraints::ConstraintLimits> limitSets =
+        limits.empty() ? std::vector<RiskConstraints::ConstraintLimits>{defaults.limits} : limits;
+
+    std::vector<Config> configs;
+    configs.reserve(windows.size() * aversions.size() * limitSets.size());
+    for (int window : windows) {
+        for (const auto& limitSet : limitSets) {
+            for (double aversion : aversions) {
+                Config config;
+                config.windowSize = window;
+                config.riskAversion = aversion;
+                config.limits = limitSet;
+                configs.push_back(config);
+            }
+        }
+    }
+    return configs;
+}
+
+ParameterSweep::ParameterSweep(const Matrix& returns,
+                               const std::vector<double>& benchmarkReturns,
+                               const std::map<int, std::string>& sectorMap,
+                               const std::vector<double>& adv)
+    : ParameterSweep(returns, benchmarkReturns, sectorMap, adv, SweepParameters()) {}
+
+ParameterSweep::ParameterSweep(const Matrix& returns,
+                               const std::vector<double>& benchmarkReturns,
+                               const std::map<int, std::string>& sectorMap,
+                               const std::vector<double>& adv,
+                               const SweepParameters& parameters)
+    : parameters_(parameters)
+    , returns_(returns)
+    , denseReturns_(returns)
+    , benchmarkReturns_(benchmarkReturns)
+    , sectorMap_(sectorMap)
+    , adv_(adv)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads)) {
+
+    if (benchmarkReturns.size() != returns.rows()) {
+        throw std::runtime_error("ParameterSweep: benchmark length does not match the return panel");
+    }
+    if (adv.size() != returns.columns()) {
+        throw std::runtime_error("ParameterSweep: ADV does not match the number of assets");
+    }
+    for (Size j = 0; j < returns.columns(); ++j) {
+        if (!sectorMap.count(static_cast<int>(j))) {
+            throw std::runtime_error("ParameterSweep: asset " + std::to_string(j) + " has no sector");
+        }
+    }
+
+    Matrix excess(returns.rows(), returns.columns());
+    for (Size t = 0; t < returns.rows(); ++t) {
+        for (Size j = 0; j < returns.columns(); ++j) {
+            excess[t][j] = returns[t][j] - benchmarkReturns[t];
+        }
+    }
+    excessReturns_ = ReturnPanel(excess);
+}
+
+std::vector<ParameterSweep::Result> ParameterSweep::run(const std::vector<Config>& configs) {
+    try {
+        PROFILE_SCOPE("sweep");
+        int maxWindow = static_cast<int>(returns_.rows()) - parameters_.holdoutDays;
+        if (parameters_.holdoutDays < 2) {
+            throw std::runtime_error("holdoutDays must be at least 2");
+        }
+
+        // Window estimates not computed by an earlier run
+        std::set<int> windows;
+        for (const auto& config : configs) {
+            if (config.windowSize < 2 || config.windowSize > maxWindow) {
+                throw std::runtime_error("window size " + std::to_string(config.windowSize) +
+                                         " outside [2, " + std::to_string(maxWindow) + "]");
+            }
+            if (!estimates_.count(config.windowSize)) {
+                windows.insert(config.windowSize);
+            }
+        }
+        std::vector<int> pending(windows.begin(), windows.end());
+        std::vector<std::shared_ptr<const WindowEstimate>> computed(pending.size());
+        {
+            PROFILE_SCOPE("sweep.window_estimates");
+            pool_->parallelFor(pending.size(), [&](size_t i, size_t) {
+                computed[i] = estimateWindow(pending[i]);
+            });
+        }
+        for (size_t i = 0; i < pending.size(); ++i) {
+            estimates_[pending[i]] = computed[i];
+        }
+
+        // The grid; estimates_ is only read from here on
+        std::vector<Result> results(configs.size());
+        {
+            PROFILE_SCOPE("sweep.configs");
+            pool_->parallelFor(configs.size(), [&](size_t i, size_t) {
+                Result& result = results[i];
+                result.configIndex = i;
+                result.config = configs[i];
+                evaluate(*estimates_.at(configs[i].windowSize), result);
+            });
+        }
+        return results;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in ParameterSweep::run: " + std::string(e.what()));
+    }
+}
+
+void ParameterSweep::writeTable(const std::string& filename, const std::vector<Result>& results) {
+    const int PRECISION = 6;
+    TextBuffer table;
+    table << "Config,Window,Risk_Aversion,Max_Position,Min_Position,Max_Sector,Max_Volatility,"
+          << "Max_Turnover,Min_Positions,Max_Positions,Feasible,Expected_Return,Volatility,"
+          << "Tracking_Error,Realized_Return,Realized_Vol,Realized_Tracking_Error,"
+          << "Sharpe_Ratio,Information_Ratio,Max_Drawdown\n";
+
+    for (const auto& result : results) {
+        const Config& config = result.config;
+        table.integer(static_cast<long long>(result.configIndex)) << ",";
+        table.integer(config.windowSize) << ",";
+        for (double value : {config.riskAversion, config.limits.maxPositionSize,
+                             config.limits.minPositionSize, config.limits.maxSectorExposure,
+                             config.limits.maxVolatility, config.limits.maxTurnover}) {
+            table.fixed(value, PRECISION) << ",";
+        }
+        table.integer(config.limits.minPositions) << ",";
+        table.integer(config.limits.maxPositions) << ",";
+        table << (result.feasible ? "1" : "0");
+
+        for (double value : {result.expectedReturn, result.volatility, result.trackingError,
+                             result.realizedReturn, result.realizedVolatility,
+                             result.realizedTrackingError, result.sharpeRatio,
+                             result.informationRatio, result.maxDrawdown}) {
+            table << ",";
+            if (result.feasible) table.fixed(value, PRECISION);
+        }
+        table << "\n";
+    }
+
+    try {
+        AsyncFileWriter::writeFile(filename, table);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error writing sweep table: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+std::shared_ptr<const ParameterSweep::WindowEstimate> ParameterSweep::estimateWindow(int windowSize) const {
+    try {
+        auto estimate = std::make_shared<WindowEstimate>();
+        Size n = returns_.columns();
+        estimate->numRows = windowSize;
+        estimate->firstRow = returns_.rows() - parameters_.holdoutDays - windowSize;
+
+        estimate->mean = returns_.columnMeans(estimate->firstRow, estimate->numRows);
+        SymmetricMatrix covariance = returns_.covariance(estimate->firstRow, estimate->numRows);
+        estimate->excessCovariance = excessReturns_.covariance(estimate->firstRow, estimate->numRows);
+        estimate->covariance = covariance.toMatrix();
+
+        PackedCholesky cholesky(covariance);
+        estimate->inverseMean = estimate->mean;
+        estimate->inverseOnes.assign(n, 1.0);
+        cholesky.solve(estimate->inverseMean.data(), estimate->inverseMean.data());
+        cholesky.solve(estimate->inverseOnes.data(), estimate->inverseOnes.data());
+
+        estimate->returns = Matrix(estimate->numRows, n);
+        estimate->benchmark = Matrix(estimate->numRows, 1);
+        for (Size t = 0; t < estimate->numRows; ++t) {
+            std::copy(denseReturns_[estimate->firstRow + t], denseReturns_[estimate->firstRow + t] + n,
+                      estimate->returns[t]);
+            estimate->benchmark[t][0] = benchmarkReturns_[estimate->firstRow + t];
+        }
+        return estimate;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error estimating window " + std::to_string(windowSize) + ": " +
+                                 std::string(e.what()));
+    }
+}
+
+void ParameterSweep::evaluate(const WindowEstimate& estimate, Result& result) const {
+    Size n = returns_.columns();
+    double lambda = result.config.riskAversion;
+    if (!(lambda > 0.0)) {
+        result.error = "riskAversion must be positive";
+        return;
+    }
+
+    // w = (Sigma^-1 mu - gamma Sigma^-1 1) / (2 lambda), gamma fixing sum(w) = 1
+    double sumMean = std::accumulate(estimate.inverseMean.begin(), estimate.inverseMean.end(), 0.0);
+    double sumOnes = std::accumulate(estimate.inverseOnes.begin(), estimate.inverseOnes.end(), 0.0);
+    double gamma = (sumMean - 2.0 * lambda) / sumOnes;
+    Matrix weights(n, 1);
+    for (Size j = 0; j < n; ++j) {
+        weights[j][0] = (estimate.inverseMean[j] - gamma * estimate.inverseOnes[j]) / (2.0 * lambda);
+    }
+
+    // Sweeps start from an equal-weight book for the turnover limit
+    Matrix currentWeights(n, 1, 1.0 / n);
+    RiskConstraints constraints(result.config.limits);
+    try {
+        weights = constraints.enforceConstraints(
+            weights, currentWeights, estimate.returns, estimate.covariance,
+            estimate.benchmark, sectorMap_, adv_);
+    }
+    catch (const std::exception& e) {
+        result.error = e.what();
+        return;
+    }
+    result.feasible = true;
+
+    result.expectedReturn = MatrixOperations::dot(estimate.mean.data(), weights.begin(), n);
+    result.volatility = std::sqrt(MatrixOperations::quadForm(estimate.covariance, weights));
+    result.trackingError = std::sqrt(MatrixOperations::quadForm(estimate.excessCovariance, weights));
+    result.weights.assign(weights.begin(), weights.end());
+
+    measureHoldout(weights, result);
+}
+
+void ParameterSweep::measureHoldout(const Matrix& weights, Result& result) const {
+    Size h = parameters_.holdoutDays;
+    Size first = returns_.rows() - h;
+    std::vector<double> portfolio(h);
+    returns_.portfolioReturns(weights.begin(), first, h, portfolio.data());
+
+    double sum = 0.0, sumActive = 0.0;
+    for (Size t = 0; t < h; ++t) {
+        sum += portfolio[t];
+        sumActive += portfolio[t] - benchmarkReturns_[first + t];
+    }
+    double mean = sum / h;
+    double meanActive = sumActive / h;
+
+    double variance = 0.0, activeVariance = 0.0;
+    for (Size t = 0; t < h; ++t) {
+        double d = portfolio[t] - mean;
+        double a = portfolio[t] - benchmarkReturns_[first + t] - meanActive;
+        variance += d * d;
+        activeVariance += a * a;
+    }
+    double vol = std::sqrt(variance / (h - 1));
+    double activeVol = std::sqrt(activeVariance / (h - 1));
+    double scale = std::sqrt(static_cast<double>(parameters_.tradingDaysPerYear));
+    double nan = std::numeric_limits<double>::quiet_NaN();
+
+    result.realizedReturn = mean * parameters_.tradingDaysPerYear;
+    result.realizedVolatility = vol * scale;
+    result.realizedTrackingError = activeVol * scale;
+    result.sharpeRatio = vol > 0.0 ? mean / vol * scale : nan;
+    result.informationRatio = activeVol > 0.0 ? meanActive / activeVol * scale : nan;
+    result.maxDrawdown = DrawdownEngine::maxDrawdown(portfolio);
+}
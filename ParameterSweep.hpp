@@ -0,0 +1,126 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ReturnPanel.hpp"
+#include "RiskConstraints.hpp"
+#include "SymmetricMatrix.hpp"
+#include "WorkStealingPool.hpp"
+
+using namespace QuantLib;
+
+// In-process grid search over risk aversion, estimation window and
+// constraint limits. The return panel is loaded once, and each distinct
+// window's estimates (mean, covariance, excess covariance and the two
+// Cholesky solves the optimizer needs) are computed once and shared by
+// every config that uses that window. The grid itself runs on a
+// work-stealing pool.
+//
+// Each config is a mean-variance solve
+//     max mu'w - lambda w'Sigma w  subject to  sum(w) = 1
+// followed by RiskConstraints::enforceConstraints with the config's
+// limits. The estimation window ends holdoutDays before the last row, so
+// every config gets ex-ante statistics on the window and realized
+// statistics on the same out-of-sample holdout.
+//
+// Rows are chronological (oldest first), as in DataManager.
+class ParameterSweep {
+public:
+    struct Config {
+        double riskAversion{3.0};
+        int windowSize{252};
+        RiskConstraints::ConstraintLimits limits;
+
+        Config() = default;
+    };
+
+    // Cartesian product, expanded window-major so configs sharing a window
+    // sit next to each other
+    struct Grid {
+        std::vector<int> windowSizes;
+        std::vector<double> riskAversions;
+        std::vector<RiskConstraints::ConstraintLimits> limits;
+
+        std::vector<Config> expand() const;
+        Grid() = default;
+    };
+
+    struct SweepParameters {
+        int holdoutDays{63};            // out-of-sample rows after the window
+        size_t numThreads{0};           // 0 = hardware concurrency
+        int tradingDaysPerYear{252};
+
+        SweepParameters() = default;
+    };
+
+    struct Result {
+        size_t configIndex{0};
+        Config config;
+        bool feasible{false};
+        std::string error;              // why enforceConstraints gave up
+
+        // Ex-ante over the estimation window (daily)
+        double expectedReturn{0.0};
+        double volatility{0.0};
+        double trackingError{0.0};
+
+        // Realized over the holdout (annualized where noted)
+        double realizedReturn{0.0};     // annualized mean
+        double realizedVolatility{0.0}; // annualized
+        double realizedTrackingError{0.0};
+        double sharpeRatio{0.0};
+        double informationRatio{0.0};
+        double maxDrawdown{0.0};
+
+        std::vector<double> weights;
+
+        Result() = default;
+    };
+
+    ParameterSweep(const Matrix& returns,
+                   const std::vector<double>& benchmarkReturns,
+                   const std::map<int, std::string>& sectorMap,
+                   const std::vector<double>& adv);
+    ParameterSweep(const Matrix& returns,
+                   const std::vector<double>& benchmarkReturns,
+                   const std::map<int, std::string>& sectorMap,
+                   const std::vector<double>& adv,
+                   const SweepParameters& parameters);
+
+    std::vector<Result> run(const std::vector<Config>& configs);
+    std::vector<Result> run(const Grid& grid) { return run(grid.expand()); }
+
+    // One row per result; infeasible configs have empty metric fields
+    static void writeTable(const std::string& filename, const std::vector<Result>& results);
+
+private:
+    // Shared per distinct window size
+    struct WindowEstimate {
+        Size firstRow{0};
+        Size numRows{0};
+        std::vector<double> mean;
+        Matrix covariance;              // dense, for RiskConstraints
+        SymmetricMatrix excessCovariance;
+        std::vector<double> inverseMean;    // Sigma^-1 mu
+        std::vector<double> inverseOnes;    // Sigma^-1 1
+        Matrix returns;                 // window rows, for the beta check
+        Matrix benchmark;
+    };
+
+    SweepParameters parameters_;
+    ReturnPanel returns_;
+    ReturnPanel excessReturns_;
+    Matrix denseReturns_;
+    std::vector<double> benchmarkReturns_;
+    std::map<int, std::string> sectorMap_;
+    std::vector<double> adv_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::map<int, std::shared_ptr<const WindowEstimate>> estimates_;
+
+    // Private helper methods
+    std::shared_ptr<const WindowEstimate> estimateWindow(int windowSize) const;
+    void evaluate(const WindowEstimate& estimate, Result& result) const;
+    void measureHoldout(const Matrix& weights, Result& result) const;
+};
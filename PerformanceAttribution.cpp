@@ -0,0 +1,377 @@
+#include "PerformanceAttribution.hpp"
+#include "MatrixOperations.hpp"
+#include "SymmetricMatrix.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+PerformanceAttribution::PerformanceAttribution()
+    : PerformanceAttribution(std::vector<double>(), std::map<int, std::string>()) {}
+
+PerformanceAttribution::PerformanceAttribution(const std::vector<double>& benchmarkWeights,
+                                               const std::map<int, std::string>& sectorMap)
+    : PerformanceAttribution(benchmarkWeights, sectorMap, AttributionParameters()) {}
+
+PerformanceAttribution::PerformanceAttribution(const std::vector<double>& benchmarkWeights,
+                                               const std::map<int, std::string>& sectorMap,
+                                               const AttributionParameters& parameters)
+    : parameters_(parameters)
+    , benchmarkWeights_(benchmarkWeights)
+    , sectorMap_(sectorMap) {
+
+    if (parameters.periodLength < 1 || parameters.tradingDaysPerYear < 1) {
+        throw std::runtime_error("PerformanceAttribution: period length and trading days must be positive");
+    }
+}
+
+PerformanceAttribution::Attribution PerformanceAttribution::analyzePerformance(
+    const Matrix& weights,
+    const Matrix& returns,
+    const Matrix& benchmarkReturns,
+    const Matrix& factorReturns) const {
+
+    try {
+        PROFILE_SCOPE("performance_attribution");
+        Panel panel = prepare(returns, benchmarkReturns, factorReturns);
+        return attribute(panel, weights);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in analyzePerformance: " + std::string(e.what()));
+    }
+}
+
+std::vector<PerformanceAttribution::Attribution> PerformanceAttribution::analyzePerformance(
+    const std::vector<Matrix>& weights,
+    const Matrix& returns,
+    const Matrix& benchmarkReturns,
+    const Matrix& factorReturns) const {
+
+    try {
+        PROFILE_SCOPE("performance_attribution_batch");
+        Panel panel = prepare(returns, benchmarkReturns, factorReturns);
+
+        std::vector<Attribution> results(weights.size());
+        pool().parallelFor(weights.size(), [&](size_t index, size_t) {
+            results[index] = attribute(panel, weights[index]);
+        });
+        return results;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in analyzePerformance: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+WorkStealingPool& PerformanceAttribution::pool() const {
+    std::call_once(poolStarted_, [this] {
+        pool_ = std::make_unique<WorkStealingPool>(parameters_.numThreads);
+    });
+    return *pool_;
+}
+
+PerformanceAttribution::Panel PerformanceAttribution::prepare(
+    const Matrix& returns,
+    const Matrix& benchmarkReturns,
+    const Matrix& factorReturns) const {
+
+    const Size T = returns.rows();
+    const Size n = returns.columns();
+    if (T == 0 || n == 0) {
+        throw std::runtime_error("empty return panel");
+    }
+    if (!benchmarkReturns.empty() && benchmarkReturns.rows() != T) {
+        throw std::runtime_error("benchmark returns do not match the return panel");
+    }
+    if (!factorReturns.empty() && factorReturns.rows() != T) {
+        throw std::runtime_error("factor returns do not match the return panel");
+    }
+    if (!benchmarkWeights_.empty() && benchmarkWeights_.size() != n) {
+        throw std::runtime_error("benchmark weights do not match the return panel");
+    }
+    Panel panel;
+    panel.benchmarkWeights = benchmarkWeights_.empty() ? std::vector<double>(n, 1.0 / n) : benchmarkWeights_;
+    const std::vector<double>& benchmark = panel.benchmarkWeights;
+    if (!checkUnitSum(benchmark.data(), n)) {
+        throw std::runtime_error("benchmark weights must sum to one");
+    }
+
+    // Sector names to dense ids; unmapped assets share one bucket
+    std::map<std::string, int> ids;
+    std::vector<int>& sectors = panel.sectors;
+    sectors.assign(n, 0);
+    for (Size i = 0; i < n; ++i) {
+        auto found = sectorMap_.find(static_cast<int>(i));
+        std::string name = found != sectorMap_.end() ? found->second
+                         : sectorMap_.empty() ? "All" : "Other";
+        auto inserted = ids.emplace(name, static_cast<int>(panel.sectorNames.size()));
+        if (inserted.second) panel.sectorNames.push_back(name);
+        sectors[i] = inserted.first->second;
+    }
+    const Size S = panel.sectorNames.size();
+    std::vector<double>& sectorWeights = panel.sectorWeights;
+    sectorWeights.assign(S, 0.0);
+    std::vector<double> sectorCounts(S, 0.0);
+    for (Size i = 0; i < n; ++i) {
+        sectorWeights[sectors[i]] += benchmark[i];
+        sectorCounts[sectors[i]] += 1.0;
+    }
+
+    const Size L = static_cast<Size>(parameters_.periodLength);
+    const Size K = factorReturns.empty() ? 0 : factorReturns.columns();
+    panel.numRows = T;
+    panel.numAssets = n;
+    panel.numFactors = K;
+    panel.numPeriods = (T + L - 1) / L;
+    panel.periodReturns = Matrix(panel.numPeriods, n);
+    panel.periodFactors = Matrix(panel.numPeriods, K);
+    panel.sectorReturns = Matrix(panel.numPeriods, S);
+    panel.benchmark.resize(panel.numPeriods);
+    panel.composite.resize(panel.numPeriods);
+
+    // Compound each period's rows, one pass over the panel
+    std::vector<double> growth(n), factorGrowth(K), sectorSums(S), sectorEqual(S);
+    for (Size p = 0; p < panel.numPeriods; ++p) {
+        std::fill(growth.begin(), growth.end(), 1.0);
+        std::fill(factorGrowth.begin(), factorGrowth.end(), 1.0);
+        double benchmarkGrowth = 1.0;
+        for (Size t = p * L; t < std::min(T, (p + 1) * L); ++t) {
+            const Real* row = returns[t];
+            for (Size i = 0; i < n; ++i) {
+                if (!std::isnan(row[i])) growth[i] *= 1.0 + row[i];
+            }
+            for (Size k = 0; k < K; ++k) {
+                double f = factorReturns[t][k];
+                if (!std::isnan(f)) factorGrowth[k] *= 1.0 + f;
+            }
+            if (!benchmarkReturns.empty() && !std::isnan(benchmarkReturns[t][0])) {
+                benchmarkGrowth *= 1.0 + benchmarkReturns[t][0];
+            }
+        }
+
+        Real* periodRow = panel.periodReturns[p];
+        std::fill(sectorSums.begin(), sectorSums.end(), 0.0);
+        std::fill(sectorEqual.begin(), sectorEqual.end(), 0.0);
+        for (Size i = 0; i < n; ++i) {
+            periodRow[i] = growth[i] - 1.0;
+            sectorSums[sectors[i]] += benchmark[i] * periodRow[i];
+            sectorEqual[sectors[i]] += periodRow[i];
+        }
+        for (Size k = 0; k < K; ++k) {
+            panel.periodFactors[p][k] = factorGrowth[k] - 1.0;
+        }
+
+        // A sector the benchmark does not hold is measured against its
+        // equal-weighted return
+        for (Size s = 0; s < S; ++s) {
+            panel.sectorReturns[p][s] = sectorWeights[s] != 0.0 ? sectorSums[s] / sectorWeights[s]
+                                                                : sectorEqual[s] / sectorCounts[s];
+        }
+        panel.composite[p] = MatrixOperations::dot(benchmark.data(), periodRow, n);
+        panel.benchmark[p] = benchmarkReturns.empty() ? panel.composite[p] : benchmarkGrowth - 1.0;
+    }
+
+    panel.benchmarkExposures.assign(K, 0.0);
+    if (K > 0) {
+        panel.loadings = decomposeFatorReturns(returns, factorReturns);
+        MatrixOperations::gemvTransposed(panel.loadings, benchmark.data(), panel.benchmarkExposures.data());
+    }
+    return panel;
+}
+
+PerformanceAttribution::Attribution PerformanceAttribution::attribute(
+    const Panel& panel, const Matrix& weights) const {
+
+    const Size n = panel.numAssets;
+    const Size K = panel.numFactors;
+    const Size P = panel.numPeriods;
+    const Size S = panel.sectorNames.size();
+    const Size L = static_cast<Size>(parameters_.periodLength);
+
+    bool path = weights.rows() == panel.numRows && weights.columns() == n;
+    if (!path && !(weights.rows() == n && weights.columns() == 1)) {
+        throw std::runtime_error("weights must be N x 1 or a T x N path");
+    }
+    auto periodWeights = [&](Size p) -> const Real* {
+        return path ? weights[p * L] : weights.begin();
+    };
+    for (Size p = 0; p < (path ? P : 1); ++p) {
+        if (!checkUnitSum(periodWeights(p), n)) {
+            throw std::runtime_error("portfolio weights must sum to one");
+        }
+    }
+
+    // Period returns first: the linking coefficients need the totals
+    std::vector<double> portfolio(P);
+    double portfolioGrowth = 1.0, compositeGrowth = 1.0, benchmarkGrowth = 1.0;
+    for (Size p = 0; p < P; ++p) {
+        portfolio[p] = MatrixOperations::dot(periodWeights(p), panel.periodReturns[p], n);
+        portfolioGrowth *= 1.0 + portfolio[p];
+        compositeGrowth *= 1.0 + panel.composite[p];
+        benchmarkGrowth *= 1.0 + panel.benchmark[p];
+    }
+
+    Attribution result;
+    result.totalReturn = portfolioGrowth - 1.0;
+    result.benchmarkReturn = benchmarkGrowth - 1.0;
+    result.benchmarkResidual = (compositeGrowth - 1.0) - result.benchmarkReturn;
+    result.factorContributions.assign(K, 0.0);
+    result.sectors.resize(S);
+    for (Size s = 0; s < S; ++s) {
+        result.sectors[s].sector = panel.sectorNames[s];
+    }
+    result.periodEffects = Matrix(P, 4, 0.0);
+
+    const double overall = linkingCoefficient(result.totalReturn, compositeGrowth - 1.0);
+    std::vector<double> sectorWeights(S), sectorSums(S), exposures(K), excess(P);
+
+    for (Size p = 0; p < P; ++p) {
+        const Real* w = periodWeights(p);
+        const Real* periodRow = panel.periodReturns[p];
+        const double Rb = panel.composite[p];
+        const double scale = linkingCoefficient(portfolio[p], Rb) / overall;
+
+        // Brinson-Fachler by sector
+        std::fill(sectorWeights.begin(), sectorWeights.end(), 0.0);
+        std::fill(sectorSums.begin(), sectorSums.end(), 0.0);
+        for (Size i = 0; i < n; ++i) {
+            sectorWeights[panel.sectors[i]] += w[i];
+            sectorSums[panel.sectors[i]] += w[i] * periodRow[i];
+        }
+        for (Size s = 0; s < S; ++s) {
+            double wp = sectorWeights[s], wb = panel.sectorWeights[s];
+            double rb = panel.sectorReturns[p][s];
+
+            double allocation = (wp - wb) * (rb - Rb);
+            double selection, interaction;
+            if (wp != 0.0) {
+                double rp = sectorSums[s] / wp;
+                selection = wb * (rp - rb);
+                interaction = (wp - wb) * (rp - rb);
+            } else {
+                // Long and short positions that net out: no sector return,
+                // so the contribution w'r is all interaction
+                selection = 0.0;
+                interaction = sectorSums[s];
+            }
+            result.periodEffects[p][0] += allocation;
+            result.periodEffects[p][1] += selection;
+            result.periodEffects[p][2] += interaction;
+
+            SectorEffect& effect = result.sectors[s];
+            effect.allocation += scale * allocation;
+            effect.selection += scale * selection;
+            effect.interaction += scale * interaction;
+        }
+        double active = portfolio[p] - Rb;
+        result.periodEffects[p][3] = active;
+        result.assetAllocation += scale * result.periodEffects[p][0];
+        result.securitySelection += scale * result.periodEffects[p][1];
+        result.interaction += scale * result.periodEffects[p][2];
+
+        // Active factor exposures times the period's factor returns
+        double explained = 0.0;
+        if (K > 0) {
+            MatrixOperations::gemvTransposed(panel.loadings, w, exposures.data());
+            for (Size k = 0; k < K; ++k) {
+                double contribution = (exposures[k] - panel.benchmarkExposures[k]) * panel.periodFactors[p][k];
+                result.factorContributions[k] += scale * contribution;
+                explained += contribution;
+            }
+        }
+        result.specificReturn += scale * (active - explained);
+        excess[p] = portfolio[p] - panel.benchmark[p];
+    }
+
+    result.informationRatio = calculateInformationRatio(excess);
+    return result;
+}
+
+Matrix PerformanceAttribution::decomposeFatorReturns(const Matrix& returns, const Matrix& factorReturns) const {
+    // OLS loadings with an intercept: (Fc'Fc)^-1 Fc'Rc on daily rows
+    const Size T = returns.rows();
+    const Size n = returns.columns();
+    const Size K = factorReturns.columns();
+    if (T <= K + 1) {
+        throw std::runtime_error("not enough observations for the factor regression");
+    }
+
+    Matrix factors = factorReturns;
+    for (Real& f : factors) {
+        if (std::isnan(f)) f = 0.0;
+    }
+    std::vector<double> factorMeans(K, 0.0), assetMeans(n, 0.0);
+    std::vector<double> row(n);
+    for (Size t = 0; t < T; ++t) {
+        MatrixOperations::axpy(1.0 / T, factors[t], factorMeans.data(), K);
+        for (Size i = 0; i < n; ++i) {
+            double r = returns[t][i];
+            assetMeans[i] += (std::isnan(r) ? 0.0 : r) / T;
+        }
+    }
+
+    // Fc'Rc, one rank-one update per row
+    Matrix cross(K, n, 0.0);
+    for (Size t = 0; t < T; ++t) {
+        for (Size i = 0; i < n; ++i) {
+            double r = returns[t][i];
+            row[i] = (std::isnan(r) ? 0.0 : r) - assetMeans[i];
+        }
+        for (Size k = 0; k < K; ++k) {
+            MatrixOperations::axpy(factors[t][k] - factorMeans[k], row.data(), cross[k], n);
+        }
+    }
+
+    SymmetricMatrix gram = MatrixOperations::sampleCovariance(factors);
+    for (Real& g : gram) {
+        g *= (T - 1);
+    }
+    Matrix solved;
+    try {
+        solved = PackedCholesky(gram).solve(cross);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("factor returns are collinear: " + std::string(e.what()));
+    }
+
+    Matrix loadings(n, K);
+    for (Size k = 0; k < K; ++k) {
+        for (Size i = 0; i < n; ++i) {
+            loadings[i][k] = solved[k][i];
+        }
+    }
+    return loadings;
+}
+
+double PerformanceAttribution::calculateInformationRatio(const std::vector<double>& excessReturns) const {
+    // NaN when undefined (fewer than two periods or no active risk)
+    const Size n = excessReturns.size();
+    if (n < 2) return std::numeric_limits<double>::quiet_NaN();
+
+    double mean = 0.0;
+    for (double r : excessReturns) mean += r;
+    mean /= n;
+    double variance = 0.0;
+    for (double r : excessReturns) variance += (r - mean) * (r - mean);
+    variance /= (n - 1);
+    if (!(variance > 0.0)) return std::numeric_limits<double>::quiet_NaN();
+
+    double periodsPerYear = static_cast<double>(parameters_.tradingDaysPerYear) / parameters_.periodLength;
+    return mean / std::sqrt(variance) * std::sqrt(periodsPerYear);
+}
+
+bool PerformanceAttribution::checkUnitSum(const Real* weights, Size n) {
+    double sum = 0.0;
+    for (Size i = 0; i < n; ++i) sum += weights[i];
+    return std::abs(sum - 1.0) <= 1e-6;
+}
+
+double PerformanceAttribution::linkingCoefficient(double portfolioReturn, double benchmarkReturn) {
+    // Carino: [ln(1 + R) - ln(1 + B)] / (R - B), 1 / (1 + R) in the limit;
+    // arithmetic (1) if either return is a total loss
+    if (!(1.0 + portfolioReturn > 0.0) || !(1.0 + benchmarkReturn > 0.0)) return 1.0;
+    double difference = portfolioReturn - benchmarkReturn;
+    if (std::abs(difference) < 1e-12) return 1.0 / (1.0 + portfolioReturn);
+    return (std::log1p(portfolioReturn) - std::log1p(benchmarkReturn)) / difference;
+}
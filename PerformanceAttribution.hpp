@@ -1,22 +1,129 @@
 #pragma once
 #include <ql/quantlib.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "WorkStealingPool.hpp"
 
+using namespace QuantLib;
+
+// Multi-period return attribution against a benchmark given by weights.
+// Daily rows are compounded into periods (periodLength rows each, the last
+// possibly shorter). Each period holds the weights of its first row, so its
+// return is the buy-and-hold w'R. Per period:
+//  - Brinson-Fachler by sector: allocation (w_p - w_b)(r_b - R_b),
+//    selection w_b (r_p - r_b), interaction (w_p - w_b)(r_p - r_b);
+//  - factor attribution: active exposures B'(w - b) times the period's
+//    compounded factor returns, with the rest reported as specific. Loadings
+//    B come from one OLS fit of daily asset returns on the factors.
+// Periods are linked geometrically (Carino): each period's effects are
+// scaled by [ln(1 + R_p) - ln(1 + R_b)] / (R_p - R_b) over the same ratio for
+// the whole horizon, so linked effects add to the compounded active return.
+//
+// Portfolio and benchmark weights must each sum to one (every period of a
+// path), otherwise the sector effects would not add to the active return.
+// A sector the portfolio nets to zero weight has no return r_p; its
+// contribution w'r is reported as interaction, so the effects still add up.
+//
+// Compounded asset and factor returns, sector benchmark returns and loadings
+// depend only on the return panel. They are built once per call and shared
+// by every portfolio in a batch, which runs on a work-stealing pool started
+// by the first batch. Calls keep no per-call state in the object, so one
+// instance may serve concurrent calls.
 class PerformanceAttribution {
 public:
+    struct AttributionParameters {
+        int periodLength{21};           // rows per period; 21 = monthly
+        int tradingDaysPerYear{252};
+        size_t numThreads{0};           // batch; 0 = hardware concurrency
+
+        AttributionParameters() = default;
+    };
+
+    // Linked Brinson effects of one sector
+    struct SectorEffect {
+        std::string sector;
+        double allocation{0.0};
+        double selection{0.0};
+        double interaction{0.0};
+    };
+
     struct Attribution {
-        double totalReturn;
-        double assetAllocation;
-        double securitySelection;
-        double interaction;
-        std::vector<double> factorContributions;
+        double totalReturn{0.0};        // portfolio, compounded
+        double assetAllocation{0.0};
+        double securitySelection{0.0};
+        double interaction{0.0};
+        std::vector<double> factorContributions;    // linked, one per factor
+
+        double benchmarkReturn{0.0};    // benchmark series, compounded
+        double benchmarkResidual{0.0};  // compounded b'R less the series
+        double specificReturn{0.0};     // active return the factors leave
+        double informationRatio{0.0};   // per-period active returns, annualized
+        std::vector<SectorEffect> sectors;
+        Matrix periodEffects;           // periods x 4: allocation, selection, interaction, active
     };
 
+    // Equal-weighted benchmark, one sector
+    PerformanceAttribution();
+    PerformanceAttribution(const std::vector<double>& benchmarkWeights,
+                           const std::map<int, std::string>& sectorMap);
+    PerformanceAttribution(const std::vector<double>& benchmarkWeights,
+                           const std::map<int, std::string>& sectorMap,
+                           const AttributionParameters& parameters);
+
+    // weights: N x 1 (reset at each period start) or a T x N path (row t
+    // held over return row t). returns: T x N, chronological.
+    // benchmarkReturns: T x 1, or empty for the b'R composite.
+    // factorReturns: T x K, or empty for no factor attribution.
+    // Missing (NaN) returns count as zero.
     Attribution analyzePerformance(const Matrix& weights,
                                  const Matrix& returns,
                                  const Matrix& benchmarkReturns,
-                                 const Matrix& factorReturns);
+                                 const Matrix& factorReturns) const;
+
+    // Many portfolios over the same panel, in parallel
+    std::vector<Attribution> analyzePerformance(const std::vector<Matrix>& weights,
+                                                const Matrix& returns,
+                                                const Matrix& benchmarkReturns,
+                                                const Matrix& factorReturns) const;
 
 private:
-    Matrix decomposeFatorReturns(const Matrix& returns);
-    double calculateInformationRatio(const std::vector<double>& excessReturns);
-}; 
\ No newline at end of file
+    // Everything that depends only on the return panel
+    struct Panel {
+        Size numRows{0};
+        Size numPeriods{0};
+        Size numAssets{0};
+        Size numFactors{0};
+        Matrix periodReturns;           // periods x N
+        Matrix periodFactors;           // periods x K
+        Matrix sectorReturns;           // periods x sectors, benchmark within-sector returns
+        std::vector<double> benchmark;  // periods, benchmark series
+        std::vector<double> composite;  // periods, b'R
+        Matrix loadings;                // N x K
+        std::vector<double> benchmarkExposures;     // B'b
+
+        // Sector layout
+        std::vector<double> benchmarkWeights;       // N, b
+        std::vector<int> sectors;                   // N, dense sector id
+        std::vector<std::string> sectorNames;
+        std::vector<double> sectorWeights;          // benchmark weight per sector
+    };
+
+    AttributionParameters parameters_;
+    std::vector<double> benchmarkWeights_;
+    std::map<int, std::string> sectorMap_;
+    mutable std::once_flag poolStarted_;
+    mutable std::unique_ptr<WorkStealingPool> pool_;
+
+    // Private helper methods
+    Panel prepare(const Matrix& returns, const Matrix& benchmarkReturns, const Matrix& factorReturns) const;
+    WorkStealingPool& pool() const;
+    Attribution attribute(const Panel& panel, const Matrix& weights) const;
+    Matrix decomposeFatorReturns(const Matrix& returns, const Matrix& factorReturns) const;
+    double calculateInformationRatio(const std::vector<double>& excessReturns) const;
+    static bool checkUnitSum(const Real* weights, Size n);
+    static double linkingCoefficient(double portfolioReturn, double benchmarkReturn);
+};
@@ -1,4 +1,5 @@
 #include "PortfolioOptimizer.hpp"
+#include "MatrixOperations.hpp"
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
@@ -9,122 +10,128 @@ Matrix PortfolioOptimizer::optimizeWithConstraints(
     const OptimizationParameters& params) {
     
     try {
-        // Initialize optimization
-        Matrix optimalWeights = currentWeights;
         params_ = params;
         
-        // Calculate initial metrics
-        double currentReturn = calculatePortfolioReturn(currentWeights);
-        double currentRisk = calculatePortfolioRisk(currentWeights);
+        // Cache Sigma w, return and cost at the current point so that each
+        // sparse candidate is priced without touching the full covariance
+        const SymmetricMatrix& covariance = dataManager_->getCovarianceMatrix();
+        IncrementalEvaluator evaluator(
+            covariance,
+            calculateExpectedReturns(),
+            params.useTransactionCosts ? costModel_.get() : nullptr,
+            portfolioValue);
+        evaluator.reset(currentWeights, currentWeights);
+        
+        // Scratch copy for constraint checks, kept in sync with the evaluator
+        Matrix candidateWeights = currentWeights;
+        IncrementalEvaluator::Move move;
         
         // Optimization loop
         for (int iter = 0; iter < params.maxIterations; ++iter) {
             bool constraintsViolated = false;
             
-            // Generate candidate weights
-            Matrix candidateWeights = generateCandidateWeights(optimalWeights);
+            // Generate candidate move
+            generateCandidateMove(evaluator.getWeights(), move);
+            if (move.assets.empty()) {
+                continue;
+            }
+            IncrementalEvaluator::Evaluation candidate = evaluator.evaluateMove(move);
             
             // Check constraints
-            if (params.useSectorConstraints && 
-                !riskConstraints_->validatePortfolio(candidateWeights, getSectorExposures())) {
-                constraintsViolated = true;
+            if (params.useSectorConstraints) {
+                for (Size m = 0; m < move.assets.size(); ++m) {
+                    Size i = move.assets[m];
+                    candidateWeights[i][0] = evaluator.getWeights()[i] + move.deltas[m];
+                }
+                if (!riskConstraints_->validatePortfolio(candidateWeights, getSectorExposures())) {
+                    constraintsViolated = true;
+                }
             }
             
             // Check transaction costs if enabled
-            if (params.useTransactionCosts) {
-                double tradingCost = costModel_->calculateTotalCost(
-                    currentWeights, candidateWeights, getPrices(), portfolioValue);
-                
-                if (tradingCost > params.maxTradingCost) {
-                    constraintsViolated = true;
-                }
+            if (params.useTransactionCosts && 
+                candidate.tradingCost > params.maxTradingCost) {
+                constraintsViolated = true;
             }
             
             // Update weights if constraints are satisfied
+            bool accepted = false;
             if (!constraintsViolated) {
-                double candidateReturn = calculatePortfolioReturn(candidateWeights);
-                double candidateRisk = calculatePortfolioRisk(candidateWeights);
-                
-                if (isImprovement(candidateReturn, candidateRisk, 
-                                currentReturn, currentRisk)) {
-                    optimalWeights = candidateWeights;
-                    currentReturn = candidateReturn;
-                    currentRisk = candidateRisk;
+                IncrementalEvaluator::Evaluation current = evaluator.current();
+                if (isImprovement(candidate.expectedReturn, candidate.risk, 
+                                current.expectedReturn, current.risk)) {
+                    evaluator.commitMove(move);
+                    accepted = true;
                 }
             }
             
-            // Check convergence
-            if (checkConvergence(currentWeights, optimalWeights, 
-                               params.convergenceTolerance)) {
-                break;
+            for (Size i : move.assets) {
+                candidateWeights[i][0] = evaluator.getWeights()[i];
+            }
+            
+            // Check convergence: stop once accepted moves become negligible
+            if (accepted) {
+                double maxDiff = 0.0;
+                for (double delta : move.deltas) {
+                    maxDiff = std::max(maxDiff, std::abs(delta));
+                }
+                if (maxDiff < params.convergenceTolerance) {
+                    break;
+                }
             }
         }
         
-        return optimalWeights;
+        return evaluator.getWeightsMatrix();
         
     } catch (const std::exception& e) {
         throw std::runtime_error("Optimization failed: " + std::string(e.what()));
     }
 }
 
-Matrix PortfolioOptimizer::generateTradeList(
+TradeListGenerator::TradeList PortfolioOptimizer::generateTradeList(
     const Matrix& currentWeights,
     const Matrix& targetWeights,
+    const std::vector<double>& prices,
     double portfolioValue) {
     
-    Matrix trades(currentWeights.rows(), 3); // [asset_index, trade_size, direction]
-    
-    for (Size i = 0; i < currentWeights.rows(); ++i) {
-        double difference = targetWeights[i][0] - currentWeights[i][0];
-        if (std::abs(difference) > params_.convergenceTolerance) {
-            trades[i][0] = i;  // asset index
-            trades[i][1] = std::abs(difference) * portfolioValue;  // trade size
-            trades[i][2] = difference > 0 ? 1 : -1;  // direction (buy/sell)
-        }
+    try {
+        TradeListGenerator::TradeListParameters parameters =
+            TradeListGenerator::fromLimits(riskConstraints_->getConstraintLimits());
+        parameters.numThreads = 1;
+        TradeListGenerator generator(parameters);
+        
+        std::vector<double> current(currentWeights.begin(), currentWeights.end());
+        std::vector<double> target(targetWeights.begin(), targetWeights.end());
+        return generator.generate(current, target, prices, portfolioValue);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Trade list generation failed: " + std::string(e.what()));
     }
-    
-    return trades;
 }
 
-bool PortfolioOptimizer::checkConvergence(
-    const Matrix& oldWeights,
-    const Matrix& newWeights,
-    double tolerance) {
+void PortfolioOptimizer::generateCandidateMove(
+    const std::vector<double>& weights,
+    IncrementalEvaluator::Move& move) {
     
-    double maxDiff = 0.0;
-    for (Size i = 0; i < oldWeights.rows(); ++i) {
-        maxDiff = std::max(maxDiff, 
-                          std::abs(oldWeights[i][0] - newWeights[i][0]));
-    }
+    move.clear();
+    Size n = weights.size();
+    if (n < 2) return;
     
-    return maxDiff < tolerance;
-}
-
-Matrix PortfolioOptimizer::generateCandidateWeights(const Matrix& currentWeights) {
-    Matrix candidate = currentWeights;
-    
-    // Generate random perturbation
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // Shift a random amount of weight between two assets; this keeps the
+    // budget and the long-only bound while touching only two coordinates
+    std::uniform_int_distribution<Size> pick(0, n - 1);
     std::normal_distribution<> d(0, 0.01);
     
-    // Apply perturbation
-    for (Size i = 0; i < candidate.rows(); ++i) {
-        candidate[i][0] += d(gen);
-    }
-    
-    // Normalize weights
-    double sum = 0.0;
-    for (Size i = 0; i < candidate.rows(); ++i) {
-        candidate[i][0] = std::max(0.0, candidate[i][0]);
-        sum += candidate[i][0];
+    Size from = pick(rng_);
+    Size to = pick(rng_);
+    while (to == from) {
+        to = pick(rng_);
     }
     
-    for (Size i = 0; i < candidate.rows(); ++i) {
-        candidate[i][0] /= sum;
-    }
+    double amount = std::min(std::abs(d(rng_)), std::max(0.0, weights[from]));
+    if (amount <= 0.0) return;
     
-    return candidate;
+    move.add(from, -amount);
+    move.add(to, amount);
 }
 
 bool PortfolioOptimizer::isImprovement(
@@ -138,14 +145,34 @@ bool PortfolioOptimizer::isImprovement(
     return newUtility > currentUtility;
 }
 
+std::vector<double> PortfolioOptimizer::calculateExpectedReturns() const {
+    const Matrix& returns = dataManager_->getReturns();
+    std::vector<double> mu(returns.columns(), 0.0);
+    
+    for (Size t = 0; t < returns.rows(); ++t) {
+        for (Size j = 0; j < returns.columns(); ++j) {
+            mu[j] += returns[t][j];
+        }
+    }
+    for (double& m : mu) {
+        m /= returns.rows();
+    }
+    
+    return mu;
+}
+
 double PortfolioOptimizer::calculatePortfolioReturn(const Matrix& weights) {
-    Matrix returns = dataManager_->getReturns();
-    return (transpose(weights) * returns)[0][0];
+    // Mean daily portfolio return, w'mu
+    std::vector<double> mu = calculateExpectedReturns();
+    if (weights.rows() != mu.size()) {
+        throw std::runtime_error("Weights do not match return columns");
+    }
+    return MatrixOperations::dot(weights.begin(), mu.data(), mu.size());
 }
 
 double PortfolioOptimizer::calculatePortfolioRisk(const Matrix& weights) {
-    Matrix covariance = dataManager_->getCovarianceMatrix();
-    return std::sqrt((transpose(weights) * covariance * weights)[0][0]);
+    const SymmetricMatrix& covariance = dataManager_->getCovarianceMatrix();
+    return std::sqrt(MatrixOperations::quadForm(covariance, weights));
 }
 
 std::vector<RiskConstraints::SectorExposure> 
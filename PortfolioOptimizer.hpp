@@ -6,6 +6,8 @@
 #include "DataManager.hpp"
 #include "RiskConstraints.hpp"
 #include "TransactionCostModel.hpp"
+#include "IncrementalEvaluator.hpp"
+#include "TradeListGenerator.hpp"
 
 using namespace QuantLib;
 
@@ -25,14 +27,14 @@ private:
     std::unique_ptr<RiskConstraints> riskConstraints_;
     std::unique_ptr<TransactionCostModel> costModel_;
     OptimizationParameters params_;
+    std::mt19937 rng_{std::random_device{}()};
 
     // Private helper methods
-    bool checkConvergence(const Matrix& oldWeights, 
-                         const Matrix& newWeights,
-                         double tolerance);
-    Matrix generateCandidateWeights(const Matrix& currentWeights);
+    void generateCandidateMove(const std::vector<double>& weights,
+                               IncrementalEvaluator::Move& move);
     bool isImprovement(double newReturn, double newRisk,
                       double currentReturn, double currentRisk);
+    std::vector<double> calculateExpectedReturns() const;
     double calculatePortfolioReturn(const Matrix& weights);
     double calculatePortfolioRisk(const Matrix& weights);
     std::vector<RiskConstraints::SectorExposure> getSectorExposures() const;
@@ -52,9 +54,12 @@ public:
                                  double portfolioValue,
                                  const OptimizationParameters& params = {});
 
-    Matrix generateTradeList(const Matrix& currentWeights,
-                           const Matrix& targetWeights,
-                           double portfolioValue);
+    // Round-lot orders for the assets that trade, within the constraint
+    // limits' minimum and maximum trade sizes
+    TradeListGenerator::TradeList generateTradeList(const Matrix& currentWeights,
+                                                    const Matrix& targetWeights,
+                                                    const std::vector<double>& prices,
+                                                    double portfolioValue);
 
     // Setters
     void setOptimizationParameters(const OptimizationParameters& params) {
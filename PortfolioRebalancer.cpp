@@ -1,15 +1,11 @@
 #include "PortfolioRebalancer.hpp"
+#include "AllocationTracker.hpp"
+#include <algorithm>
 
 void PortfolioRebalancer::updateRebalancingDates(const vector<string>& allDates) {
-    // Extract month-end dates
-    string currentMonth = "";
-    for (const auto& date : allDates) {
-        string month = date.substr(0, date.find_last_of('/'));
-        if (month != currentMonth) {
-            rebalanceDates_.push_back(date);
-            currentMonth = month;
-        }
-    }
+    // Month-end dates from the calendar's boundary table
+    calendar_ = TradingCalendar(allDates);
+    rebalanceDays_ = calendar_.periodEndDays(TradingCalendar::Period::Month);
 }
 
 Real PortfolioRebalancer::calculateTurnover(const Matrix& oldWeights, 
@@ -22,9 +18,11 @@ Real PortfolioRebalancer::calculateTurnover(const Matrix& oldWeights,
 }
 
 void PortfolioRebalancer::rebalance(const string& currentDate) {
+    ALLOCATION_SCOPE("rebalance_step");
+
     // Check if rebalancing is needed
-    if (std::find(rebalanceDates_.begin(), rebalanceDates_.end(), 
-                  currentDate) == rebalanceDates_.end()) {
+    if (!std::binary_search(rebalanceDays_.begin(), rebalanceDays_.end(),
+                            TradingCalendar::dayNumber(currentDate))) {
         return;  // Not a rebalancing date
     }
 
@@ -1,6 +1,8 @@
 #pragma once
 #include "PortfolioOptimizer.hpp"
 #include "TransactionCostModel.hpp"
+#include "TradingCalendar.hpp"
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -11,7 +13,8 @@ private:
     TransactionCostModel costModel_;
     
     Matrix currentWeights_;
-    vector<string> rebalanceDates_;
+    TradingCalendar calendar_;
+    std::vector<int32_t> rebalanceDays_;  // sorted day numbers of month-end rows
     int currentPeriod_;
 
     void updateRebalancingDates(const vector<string>& allDates);
@@ -24,4 +27,5 @@ public:
     void initialize(const Matrix& initialWeights);
     void rebalance(const string& currentDate);
     Matrix getCurrentWeights() const { return currentWeights_; }
+    const TradingCalendar& getCalendar() const { return calendar_; }
 }; 
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace Profiling {
+
+namespace {
+
+    struct TimerStats {
+        uint64_t count{0};
+        uint64_t totalNs{0};
+        uint64_t minNs{UINT64_MAX};
+        uint64_t maxNs{0};
+
+        void add(uint64_t ns) {
+            ++count;
+            totalNs += ns;
+            minNs = std::min(minNs, ns);
+            maxNs = std::max(maxNs, ns);
+        }
+        void merge(const TimerStats& other) {
+            count += other.count;
+            totalNs += other.totalNs;
+            minNs = std::min(minNs, other.minNs);
+            maxNs = std::max(maxNs, other.maxNs);
+        }
+    };
+
+    struct TraceEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint32_t thread;
+    };
+
+    struct ThreadData;
+
+    // Process-wide state; only touched on thread start/exit and at dump
+    struct Registry {
+        std::mutex mutex;
+        std::set<ThreadData*> live;
+        std::map<std::string, TimerStats> timers;
+        std::map<std::string, uint64_t> counters;
+        std::vector<TraceEvent> events;
+        uint32_t nextThread{0};
+
+        std::string path;
+        Format format{Format::Json};
+        std::atomic<bool> tracing{false};
+        std::atomic<size_t> traceCapacity{1 << 20};
+
+        Registry() {
+            if (const char* env = std::getenv("PORTFOLIO_PROFILE")) {
+                path = env;
+                const char* fmt = std::getenv("PORTFOLIO_PROFILE_FORMAT");
+                format = (fmt && std::string(fmt) == "trace") ? Format::ChromeTrace : Format::Json;
+                tracing = format == Format::ChromeTrace;
+            }
+        }
+        ~Registry() { write(); }
+
+        void write();
+        void collect(std::map<std::string, TimerStats>& timersOut,
+                     std::map<std::string, uint64_t>& countersOut,
+                     std::vector<TraceEvent>& eventsOut);
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // Per-thread aggregates keyed by the literal's address; merged by name.
+    // The mutex is only contended while collect() reads a live thread.
+    struct ThreadData {
+        uint32_t thread;
+        std::mutex mutex;
+        std::unordered_map<const char*, TimerStats> timers;
+        std::unordered_map<const char*, uint64_t> counters;
+        std::vector<TraceEvent> events;
+
+        ThreadData() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            thread = reg.nextThread++;
+            reg.live.insert(this);
+        }
+
+        ~ThreadData() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (const auto& entry : timers) reg.timers[entry.first].merge(entry.second);
+            for (const auto& entry : counters) reg.counters[entry.first] += entry.second;
+            reg.events.insert(reg.events.end(), events.begin(), events.end());
+            reg.live.erase(this);
+        }
+    };
+
+    ThreadData& threadData() {
+        thread_local ThreadData data;
+        return data;
+    }
+
+    void Registry::collect(std::map<std::string, TimerStats>& timersOut,
+                           std::map<std::string, uint64_t>& countersOut,
+                           std::vector<TraceEvent>& eventsOut) {
+        std::lock_guard<std::mutex> lock(mutex);
+        timersOut = timers;
+        countersOut = counters;
+        eventsOut = events;
+        for (ThreadData* data : live) {
+            std::lock_guard<std::mutex> dataLock(data->mutex);
+            for (const auto& entry : data->timers) timersOut[entry.first].merge(entry.second);
+            for (const auto& entry : data->counters) countersOut[entry.first] += entry.second;
+            eventsOut.insert(eventsOut.end(), data->events.begin(), data->events.end());
+        }
+    }
+
+    std::string escape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    void Registry::write() {
+        if (path.empty()) return;
+
+        std::map<std::string, TimerStats> allTimers;
+        std::map<std::string, uint64_t> allCounters;
+        std::vector<TraceEvent> allEvents;
+        collect(allTimers, allCounters, allEvents);
+
+        std::ofstream out(path);
+        if (!out.is_open()) return;
+
+        if (format == Format::ChromeTrace) {
+            // Complete ("X") events in microseconds, counters as a final "C" sample
+            std::sort(allEvents.begin(), allEvents.end(),
+                      [](const TraceEvent& a, const TraceEvent& b) { return a.startNs < b.startNs; });
+            uint64_t epochNs = allEvents.empty() ? 0 : allEvents.front().startNs;
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            uint64_t lastNs = 0;
+            for (const auto& event : allEvents) {
+                out << (first ? "" : ",") << "\n{\"name\":\"" << escape(event.name)
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                    << ",\"ts\":" << (event.startNs - epochNs) / 1000.0
+                    << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+                lastNs = std::max(lastNs, event.startNs - epochNs + event.durationNs);
+                first = false;
+            }
+            for (const auto& counter : allCounters) {
+                out << (first ? "" : ",") << "\n{\"name\":\"" << escape(counter.first)
+                    << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << lastNs / 1000.0
+                    << ",\"args\":{\"value\":" << counter.second << "}}";
+                first = false;
+            }
+            out << "\n]}\n";
+        } else {
+            out << "{\n  \"timers\": {";
+            bool first = true;
+            for (const auto& timer : allTimers) {
+                const TimerStats& stats = timer.second;
+                out << (first ? "" : ",") << "\n    \"" << escape(timer.first) << "\": {"
+                    << "\"count\": " << stats.count
+                    << ", \"total_ms\": " << stats.totalNs / 1e6
+                    << ", \"mean_us\": " << (stats.count ? stats.totalNs / 1e3 / stats.count : 0.0)
+                    << ", \"min_us\": " << (stats.count ? stats.minNs / 1e3 : 0.0)
+                    << ", \"max_us\": " << stats.maxNs / 1e3 << "}";
+                first = false;
+            }
+            out << "\n  },\n  \"counters\": {";
+            first = true;
+            for (const auto& counter : allCounters) {
+                out << (first ? "" : ",") << "\n    \"" << escape(counter.first) << "\": " << counter.second;
+                first = false;
+            }
+            out << "\n  }\n}\n";
+        }
+    }
+}
+
+void setOutput(const std::string& path, Format format) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.path = path;
+    reg.format = format;
+    reg.tracing = format == Format::ChromeTrace;
+}
+
+void setTraceCapacity(size_t eventsPerThread) {
+    registry().traceCapacity = eventsPerThread;
+}
+
+void dump() {
+    registry().write();
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void recordTime(const char* name, uint64_t startNs, uint64_t durationNs) {
+    ThreadData& data = threadData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.timers[name].add(durationNs);
+    Registry& reg = registry();
+    if (reg.tracing.load(std::memory_order_relaxed) &&
+        data.events.size() < reg.traceCapacity.load(std::memory_order_relaxed)) {
+        data.events.push_back(TraceEvent{name, startNs, durationNs, data.thread});
+    }
+}
+
+void recordCount(const char* name, uint64_t value) {
+    ThreadData& data = threadData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.counters[name] += value;
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Stage-level instrumentation: scoped RAII timers and counters, aggregated
+// per thread (behind an uncontended per-thread lock, so dump() can read
+// live threads safely) and merged when a thread exits.
+// The merged aggregates are written at process exit, either as a JSON
+// summary (count/total/mean/min/max per stage, counter totals) or as a
+// Chrome trace (chrome://tracing, Perfetto) with one event per timed scope.
+//
+// Compiled in only with -DPORTFOLIO_PROFILING; otherwise PROFILE_SCOPE and
+// PROFILE_COUNT expand to nothing. The output path comes from setOutput()
+// or the PORTFOLIO_PROFILE environment variable; PORTFOLIO_PROFILE_FORMAT=trace
+// selects the Chrome trace format.
+namespace Profiling {
+
+    enum class Format { Json, ChromeTrace };
+
+    void setOutput(const std::string& path, Format format = Format::Json);
+
+    // Trace events kept per thread before further events are dropped
+    void setTraceCapacity(size_t eventsPerThread);
+
+    // Writes the aggregates now (also done automatically at exit)
+    void dump();
+
+    uint64_t nowNs();
+    void recordTime(const char* name, uint64_t startNs, uint64_t durationNs);
+    void recordCount(const char* name, uint64_t value);
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(const char* name) : name_(name), start_(nowNs()) {}
+        ~ScopedTimer() { recordTime(name_, start_, nowNs() - start_); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t start_;
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PORTFOLIO_PROFILING
+#define PROFILE_SCOPE(name) ::Profiling::ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_COUNT(name, value) ::Profiling::recordCount(name, value)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(name, value) ((void)0)
+#endif
@@ -0,0 +1,178 @@
+#include "ResampledFrontier.hpp"
+#include "LRUCache.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+ResampledFrontier::ResampledFrontier()
+    : ResampledFrontier(ResampleParameters()) {}
+
+ResampledFrontier::ResampledFrontier(const ResampleParameters& parameters)
+    : parameters_(parameters)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads))
+    , workspaces_(pool_->size()) {}
+
+ResampledFrontier::Frontier ResampledFrontier::compute(const Matrix& windowReturns) {
+    ReturnPanel panel(windowReturns);
+    return compute(panel, 0, panel.rows());
+}
+
+ResampledFrontier::Frontier ResampledFrontier::compute(const ReturnPanel& returns, Size firstRow, Size numRows) {
+    try {
+        PROFILE_SCOPE("resampled_frontier");
+        const int B = parameters_.numResamples;
+        const int P = parameters_.numPoints;
+        const Size n = returns.columns();
+        if (B < 1 || P < 2) {
+            throw std::runtime_error("need at least one resample and two frontier points");
+        }
+
+        // Original estimates: the parametric source and the final yardstick
+        std::vector<double> mean = returns.columnMeans(firstRow, numRows);
+        SymmetricMatrix covariance = returns.covariance(firstRow, numRows);
+        PackedCholesky cholesky(covariance);
+
+        // A mask left by an earlier call with gaps would hide cells of this one
+        for (auto& workspace : workspaces_) {
+            if (workspace.sample.rows() != numRows || workspace.sample.columns() != n) {
+                workspace.sample = ReturnPanel(numRows, n);
+            }
+            workspace.sample.clearMissing();
+            workspace.sampleMean.resize(n);
+            workspace.inverseMean.resize(n);
+            workspace.inverseOnes.resize(n);
+            workspace.rows.resize(numRows);
+            workspace.draw.resize(n);
+        }
+
+        // One P x N slice per resample, reduced below in resample order
+        const Size slice = static_cast<Size>(P) * n;
+        std::vector<double> frontiers(static_cast<Size>(B) * slice);
+        std::vector<char> used(B, 0);
+        pool_->parallelFor(B, [&](size_t b, size_t worker) {
+            used[b] = resample(returns, firstRow, numRows, mean, cholesky, b,
+                               workspaces_[worker], frontiers.data() + b * slice);
+        });
+
+        Frontier frontier;
+        std::vector<double> average(slice, 0.0);
+        for (int b = 0; b < B; ++b) {
+            if (!used[b]) {
+                ++frontier.resamplesSkipped;
+                continue;
+            }
+            MatrixOperations::axpy(1.0, frontiers.data() + b * slice, average.data(), slice);
+            ++frontier.resamplesUsed;
+        }
+        if (frontier.resamplesUsed == 0) {
+            throw std::runtime_error("every resample produced a singular covariance");
+        }
+
+        frontier.points.resize(P);
+        for (int k = 0; k < P; ++k) {
+            Point& point = frontier.points[k];
+            point.targetRank = static_cast<double>(k) / (P - 1);
+            point.weights.assign(average.begin() + k * n, average.begin() + (k + 1) * n);
+            for (double& w : point.weights) {
+                w /= frontier.resamplesUsed;
+            }
+            point.expectedReturn = MatrixOperations::dot(mean.data(), point.weights.data(), n);
+            point.volatility = std::sqrt(MatrixOperations::quadForm(covariance, point.weights.data()));
+        }
+        return frontier;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in ResampledFrontier::compute: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+bool ResampledFrontier::resample(const ReturnPanel& returns, Size firstRow, Size numRows,
+                                 const std::vector<double>& mean, const PackedCholesky& cholesky,
+                                 size_t b, Workspace& workspace, double* frontier) const {
+    const Size n = returns.columns();
+    std::mt19937_64 rng(MemoHash::combine(parameters_.seed, b));
+    ReturnPanel& sample = workspace.sample;
+
+    if (parameters_.sampling == Sampling::Bootstrap) {
+        // Draw whole rows so cross-sectional dependence is kept
+        std::uniform_int_distribution<Size> pick(0, numRows - 1);
+        std::vector<Size>& rows = workspace.rows;
+        for (Size t = 0; t < numRows; ++t) {
+            rows[t] = firstRow + pick(rng);
+        }
+        // The previous resample's gaps are cleared in place
+        sample.clearMissing();
+        for (Size j = 0; j < n; ++j) {
+            Real* dst = sample.column(j);
+            for (Size t = 0; t < numRows; ++t) {
+                dst[t] = returns(rows[t], j);
+                if (!returns.isValid(rows[t], j)) sample.setMissing(t, j);
+            }
+        }
+    } else {
+        // x = mu + U'z with Sigma = U'U
+        std::normal_distribution<double> normal;
+        std::vector<double>& x = workspace.draw;
+        const SymmetricMatrix& factor = cholesky.factor();
+        for (Size t = 0; t < numRows; ++t) {
+            std::copy(mean.begin(), mean.end(), x.begin());
+            for (Size i = 0; i < n; ++i) {
+                MatrixOperations::axpy(normal(rng), factor.row(i), x.data() + i, n - i);
+            }
+            for (Size j = 0; j < n; ++j) {
+                sample(t, j) = x[j];
+            }
+        }
+    }
+
+    try {
+        sample.covariance(0, numRows, workspace.sampleCovariance, workspace.covarianceWorkspace);
+        workspace.sampleCholesky.factorize(workspace.sampleCovariance);
+        sample.columnMeans(0, numRows, workspace.sampleMean.data());
+        return solveFrontier(workspace.sampleMean, workspace.sampleCholesky,
+                             parameters_.numPoints, workspace, frontier);
+    }
+    catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+bool ResampledFrontier::solveFrontier(const std::vector<double>& mean, const PackedCholesky& cholesky,
+                                      int numPoints, Workspace& workspace, double* frontier) {
+    const Size n = mean.size();
+    std::vector<double>& inverseMean = workspace.inverseMean;
+    std::vector<double>& inverseOnes = workspace.inverseOnes;
+    std::copy(mean.begin(), mean.end(), inverseMean.begin());
+    std::fill(inverseOnes.begin(), inverseOnes.end(), 1.0);
+    cholesky.solve(inverseMean.data(), inverseMean.data());
+    cholesky.solve(inverseOnes.data(), inverseOnes.data());
+
+    double A = MatrixOperations::dot(mean.data(), inverseMean.data(), n);
+    double B = 0.0, C = 0.0;
+    for (Size j = 0; j < n; ++j) {
+        B += inverseMean[j];
+        C += inverseOnes[j];
+    }
+    double D = A * C - B * B;
+    if (!(D > 1e-12 * A * C)) {
+        return false;   // all means (nearly) equal: no frontier
+    }
+
+    // w(m) = ((C m - B) Sigma^-1 mu + (A - B m) Sigma^-1 1) / D
+    double lo = *std::min_element(mean.begin(), mean.end());
+    double hi = *std::max_element(mean.begin(), mean.end());
+    for (int k = 0; k < numPoints; ++k) {
+        double target = lo + (hi - lo) * k / (numPoints - 1);
+        double a = (C * target - B) / D;
+        double c = (A - B * target) / D;
+        double* w = frontier + k * n;
+        for (Size j = 0; j < n; ++j) {
+            w[j] = a * inverseMean[j] + c * inverseOnes[j];
+        }
+    }
+    return true;
+}
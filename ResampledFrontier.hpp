@@ -0,0 +1,86 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ReturnPanel.hpp"
+#include "SymmetricMatrix.hpp"
+#include "WorkStealingPool.hpp"
+
+using namespace QuantLib;
+
+// Resampled (Michaud) efficient frontier. Each of B resamples draws a new
+// return window, either rows bootstrapped with replacement from the original
+// window or multivariate normal draws from its mean and covariance. It then
+// re-estimates mu and Sigma and solves the budget-constrained Markowitz
+// frontier at numPoints evenly spaced target returns between the resample's
+// smallest and largest mean. Portfolio k of the resampled frontier is the
+// average of portfolio k (by rank) over all resamples, evaluated under the
+// original estimates.
+//
+// Resample b is seeded from (seed, b) alone and writes its own slice of the
+// result, which is reduced in resample order, so the output is identical for
+// any thread count. Every worker keeps its own sample panel, mean,
+// covariance, Cholesky factor and solve buffers, so after the first resample
+// a worker allocates nothing, gaps in the panel included. Resamples whose
+// covariance is not positive definite are skipped and counted.
+class ResampledFrontier {
+public:
+    enum class Sampling { Bootstrap, Parametric };
+
+    struct ResampleParameters {
+        int numResamples{500};
+        int numPoints{50};
+        Sampling sampling{Sampling::Bootstrap};
+        uint64_t seed{20240101};
+        size_t numThreads{0};           // 0 = hardware concurrency
+
+        ResampleParameters() = default;
+    };
+
+    struct Point {
+        double targetRank{0.0};         // 0 = lowest target, 1 = highest
+        double expectedReturn{0.0};     // under the original estimates
+        double volatility{0.0};
+        std::vector<double> weights;
+    };
+
+    struct Frontier {
+        std::vector<Point> points;
+        int resamplesUsed{0};
+        int resamplesSkipped{0};
+    };
+
+    ResampledFrontier();
+    explicit ResampledFrontier(const ResampleParameters& parameters);
+
+    // Rows [firstRow, firstRow + numRows) of the panel are the window
+    Frontier compute(const ReturnPanel& returns, Size firstRow, Size numRows);
+
+    // Every row of the matrix is an observation (row order is irrelevant)
+    Frontier compute(const Matrix& windowReturns);
+
+private:
+    struct Workspace {
+        ReturnPanel sample;
+        std::vector<double> sampleMean;
+        SymmetricMatrix sampleCovariance;
+        ReturnPanel::CovarianceWorkspace covarianceWorkspace;
+        PackedCholesky sampleCholesky;
+        std::vector<double> inverseMean;
+        std::vector<double> inverseOnes;
+        std::vector<Size> rows;         // bootstrap row indices
+        std::vector<double> draw;       // one parametric observation
+    };
+
+    ResampleParameters parameters_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::vector<Workspace> workspaces_;
+
+    // Private helper methods
+    bool resample(const ReturnPanel& returns, Size firstRow, Size numRows,
+                  const std::vector<double>& mean, const PackedCholesky& cholesky,
+                  size_t b, Workspace& workspace, double* frontier) const;
+    static bool solveFrontier(const std::vector<double>& mean, const PackedCholesky& cholesky,
+                              int numPoints, Workspace& workspace, double* frontier);
+};
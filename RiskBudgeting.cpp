@@ -0,0 +1,177 @@
+#include "RiskBudgeting.hpp"
+#include "MatrixOperations.hpp"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+RiskBudgetAllocator::RiskBudgetAllocator()
+    : params_() {}
+
+RiskBudgetAllocator::RiskBudgetAllocator(const SolverParameters& params)
+    : params_(params) {}
+
+RiskBudgetAllocator::Allocation RiskBudgetAllocator::equalRiskContribution(
+    const Matrix& covariance) {
+
+    try {
+        std::vector<double> budgets(covariance.rows(), 1.0);
+        return allocateToBudgets(covariance, budgets);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in equalRiskContribution: " + std::string(e.what()));
+    }
+}
+
+RiskBudgetAllocator::Allocation RiskBudgetAllocator::allocateToBudgets(
+    const Matrix& covariance,
+    const std::vector<double>& budgets) {
+
+    try {
+        Size n = covariance.rows();
+        if (n == 0 || covariance.columns() != n) {
+            throw std::runtime_error("Covariance matrix must be square and non-empty");
+        }
+        if (budgets.size() != n) {
+            throw std::runtime_error("Budget vector size does not match covariance");
+        }
+
+        double budgetSum = 0.0;
+        for (double b : budgets) {
+            if (!(b > 0.0)) {
+                throw std::runtime_error("Risk budgets must be strictly positive");
+            }
+            budgetSum += b;
+        }
+        budgets_.resize(n);
+        for (Size i = 0; i < n; ++i) {
+            budgets_[i] = budgets[i] / budgetSum;
+        }
+
+        initializeState(covariance);
+
+        int sweep = 0;
+        bool converged = false;
+        while (sweep < params_.maxSweeps) {
+            double variance = coordinateSweep(covariance);
+            ++sweep;
+            if (budgetError(variance) < params_.tolerance) {
+                converged = true;
+                break;
+            }
+        }
+
+        return buildAllocation(sweep, converged);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in allocateToBudgets: " + std::string(e.what()));
+    }
+}
+
+RiskBudgetAllocator::Allocation RiskBudgetAllocator::allocateToSectorBudgets(
+    const Matrix& covariance,
+    const std::map<int, std::string>& sectorMap,
+    const std::map<std::string, double>& sectorBudgets) {
+
+    try {
+        Size n = covariance.rows();
+        std::map<std::string, int> sectorCounts;
+        for (Size i = 0; i < n; ++i) {
+            sectorCounts[sectorMap.at(i)]++;
+        }
+
+        // Each sector's budget is shared equally by its members
+        std::vector<double> budgets(n);
+        for (Size i = 0; i < n; ++i) {
+            const std::string& sector = sectorMap.at(i);
+            auto it = sectorBudgets.find(sector);
+            if (it == sectorBudgets.end()) {
+                throw std::runtime_error("No risk budget for sector " + sector);
+            }
+            budgets[i] = it->second / sectorCounts[sector];
+        }
+
+        return allocateToBudgets(covariance, budgets);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in allocateToSectorBudgets: " + std::string(e.what()));
+    }
+}
+
+// Private helper methods
+void RiskBudgetAllocator::initializeState(const Matrix& covariance) {
+    Size n = covariance.rows();
+
+    for (Size i = 0; i < n; ++i) {
+        if (!(covariance[i][i] > 0.0)) {
+            throw std::runtime_error("Covariance diagonal must be positive");
+        }
+    }
+
+    // Warm start from the previous solution, otherwise inverse volatility
+    bool reuse = params_.warmStart && y_.size() == n;
+    if (!reuse) {
+        y_.resize(n);
+        for (Size i = 0; i < n; ++i) {
+            y_[i] = std::sqrt(budgets_[i]) / std::sqrt(covariance[i][i]);
+        }
+    }
+
+    // Full Sigma y once; the sweeps keep it current incrementally
+    sigmaY_.resize(n);
+    MatrixOperations::symv(covariance, y_.data(), sigmaY_.data());
+}
+
+double RiskBudgetAllocator::coordinateSweep(const Matrix& covariance) {
+    Size n = y_.size();
+
+    for (Size i = 0; i < n; ++i) {
+        double a = covariance[i][i];
+        double c = sigmaY_[i] - a * y_[i];
+
+        // Positive root of  a y^2 + c y - b = 0
+        double yNew = (-c + std::sqrt(c * c + 4.0 * a * budgets_[i])) / (2.0 * a);
+        double delta = yNew - y_[i];
+        if (delta == 0.0) continue;
+
+        // Sigma is symmetric, so row i doubles as column i
+        MatrixOperations::axpy(delta, covariance[i], sigmaY_.data(), n);
+        y_[i] = yNew;
+    }
+
+    return MatrixOperations::dot(y_.data(), sigmaY_.data(), n);
+}
+
+double RiskBudgetAllocator::budgetError(double variance) const {
+    double maxError = 0.0;
+    for (Size i = 0; i < y_.size(); ++i) {
+        double share = y_[i] * sigmaY_[i] / variance;
+        maxError = std::max(maxError, std::abs(share - budgets_[i]));
+    }
+    return maxError;
+}
+
+RiskBudgetAllocator::Allocation RiskBudgetAllocator::buildAllocation(
+    int sweeps,
+    bool converged) const {
+
+    Size n = y_.size();
+    double total = std::accumulate(y_.begin(), y_.end(), 0.0);
+
+    double variance = MatrixOperations::dot(y_.data(), sigmaY_.data(), n);
+
+    // Rescale y to fully invested weights; Sigma w = Sigma y / total
+    Allocation allocation;
+    allocation.weights = Matrix(n, 1);
+    allocation.riskContributions = Matrix(n, 1);
+    allocation.portfolioVol = std::sqrt(variance) / total;
+    for (Size i = 0; i < n; ++i) {
+        double w = y_[i] / total;
+        allocation.weights[i][0] = w;
+        allocation.riskContributions[i][0] = w * (sigmaY_[i] / total) / allocation.portfolioVol;
+    }
+    allocation.maxBudgetError = budgetError(variance);
+    allocation.sweeps = sweeps;
+    allocation.converged = converged;
+
+    return allocation;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <vector>
+#include <map>
+#include <string>
+#include <stdexcept>
+
+using namespace QuantLib;
+
+// Risk-budgeting allocator: finds long-only weights whose risk contributions
+// w_i (Sigma w)_i / sigma match a target budget vector. Uses cyclical
+// coordinate descent on  1/2 y'Sigma y - sum b_i ln(y_i)  and keeps Sigma y
+// up to date incrementally, so each coordinate step costs O(N).
+class RiskBudgetAllocator {
+public:
+    struct SolverParameters {
+        int maxSweeps{1000};              // Maximum full passes over all coordinates
+        double tolerance{1e-8};           // Max absolute budget-share error at convergence
+        bool warmStart{true};             // Start from the previous solution when sizes match
+
+        SolverParameters() = default;
+    };
+
+    struct Allocation {
+        Matrix weights;                   // N x 1, sums to one
+        Matrix riskContributions;         // N x 1, w_i (Sigma w)_i / sigma
+        double portfolioVol{0.0};
+        double maxBudgetError{0.0};       // max_i |RC_i / sigma - b_i|
+        int sweeps{0};
+        bool converged{false};
+
+        Allocation() = default;
+    };
+
+    RiskBudgetAllocator();
+    explicit RiskBudgetAllocator(const SolverParameters& params);
+    ~RiskBudgetAllocator() = default;
+
+    // Equal risk contribution (every asset gets budget 1/N)
+    Allocation equalRiskContribution(const Matrix& covariance);
+
+    // Arbitrary per-asset budgets (normalized internally, must be positive)
+    Allocation allocateToBudgets(
+        const Matrix& covariance,
+        const std::vector<double>& budgets);
+
+    // Per-sector budgets, split equally across the members of each sector
+    Allocation allocateToSectorBudgets(
+        const Matrix& covariance,
+        const std::map<int, std::string>& sectorMap,
+        const std::map<std::string, double>& sectorBudgets);
+
+    // Utility methods
+    void setSolverParameters(const SolverParameters& params) { params_ = params; }
+    SolverParameters getSolverParameters() const { return params_; }
+    void resetWarmStart() { y_.clear(); }
+
+private:
+    SolverParameters params_;
+
+    // Solver workspace, reused between calls to avoid reallocation
+    std::vector<double> y_;
+    std::vector<double> sigmaY_;
+    std::vector<double> budgets_;
+
+    // Helper methods
+    void initializeState(const Matrix& covariance);
+    double coordinateSweep(const Matrix& covariance);
+    double budgetError(double variance) const;
+    Allocation buildAllocation(int sweeps, bool converged) const;
+};
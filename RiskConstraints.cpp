@@ -1,9 +1,16 @@
 #include "RiskConstraints.hpp"
+#include "CardinalityOptimizer.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
 #include <sstream>
 
+RiskConstraints::RiskConstraints()
+    : RiskConstraints(ConstraintLimits()) {}
+
 RiskConstraints::RiskConstraints(const ConstraintLimits& limits)
     : limits_(limits), lastStatus_() {}
 
@@ -114,7 +121,7 @@ bool RiskConstraints::checkVolatilityLimit(
     const Matrix& covariance) {
     
     try {
-        double portfolioVol = sqrt((transpose(weights)*covariance*weights)[0][0]);
+        double portfolioVol = sqrt(MatrixOperations::quadForm(covariance, weights));
         return portfolioVol <= limits_.maxVolatility;
     }
     catch (const std::exception& e) {
@@ -127,7 +134,7 @@ bool RiskConstraints::checkTrackingError(
     const Matrix& excessCovariance) {
     
     try {
-        double trackingError = sqrt((transpose(weights)*excessCovariance*weights)[0][0]);
+        double trackingError = sqrt(MatrixOperations::quadForm(excessCovariance, weights));
         return trackingError <= limits_.maxTrackingError;
     }
     catch (const std::exception& e) {
@@ -184,11 +191,12 @@ bool RiskConstraints::checkBetaDeviation(
     
     try {
         // Calculate portfolio beta
-        Matrix portfolioReturns = returns * weights;
+        std::vector<double> portfolioReturns(returns.rows());
+        MatrixOperations::gemv(returns, weights.begin(), portfolioReturns.data());
         double covar = 0.0, benchmarkVar = 0.0;
         
         for (int i = 0; i < returns.rows(); ++i) {
-            covar += portfolioReturns[i][0] * benchmarkReturns[i][0];
+            covar += portfolioReturns[i] * benchmarkReturns[i][0];
             benchmarkVar += benchmarkReturns[i][0] * benchmarkReturns[i][0];
         }
         
@@ -210,17 +218,27 @@ Matrix RiskConstraints::enforceConstraints(
     const std::vector<double>& adv) {
     
     try {
+        PROFILE_SCOPE("enforce_constraints");
+        ALLOCATION_SCOPE("enforce_constraints");
         int maxIterations = 100;
         int iteration = 0;
         bool constraintsSatisfied = false;
         
         while (!constraintsSatisfied && iteration < maxIterations) {
+            PROFILE_SCOPE("enforce_constraints.iteration");
+            ALLOCATION_SCOPE("enforce_constraints.iteration");
+            
             // Adjust position sizes
             proposedWeights = adjustPositionSizes(proposedWeights);
             
             // Adjust sector exposures
             proposedWeights = adjustSectorExposures(proposedWeights, sectorMap);
             
+            // Select names when the position count is out of range (opt-in)
+            if (limits_.enforceCardinality && !checkDiversification(proposedWeights)) {
+                proposedWeights = adjustDiversification(proposedWeights, covariance, sectorMap);
+            }
+            
             // Adjust for volatility
             proposedWeights = adjustForVolatility(proposedWeights, covariance);
             
@@ -282,7 +300,7 @@ Matrix RiskConstraints::adjustForVolatility(
     Matrix weights,
     const Matrix& covariance) {
     
-    double portfolioVol = sqrt((transpose(weights)*covariance*weights)[0][0]);
+    double portfolioVol = sqrt(MatrixOperations::quadForm(covariance, weights));
     
     if (portfolioVol > limits_.maxVolatility) {
         double scaleFactor = limits_.maxVolatility / portfolioVol;
@@ -308,6 +326,32 @@ Matrix RiskConstraints::adjustForLiquidity(
     return weights;
 }
 
+Matrix RiskConstraints::adjustDiversification(
+    const Matrix& weights,
+    const Matrix& covariance,
+    const std::map<int, std::string>& sectorMap) {
+    
+    try {
+        if (limits_.minPositionSize < 0.0) {
+            throw std::runtime_error("cardinality selection is long only; minPositionSize allows shorts");
+        }
+        std::vector<double> target(weights.begin(), weights.end());
+        // Single-threaded: enforceConstraints already runs inside sweep tasks
+        CardinalityOptimizer::CardinalityParameters parameters = CardinalityOptimizer::fromLimits(limits_);
+        parameters.numThreads = 1;
+        CardinalityOptimizer optimizer(parameters);
+        CardinalityOptimizer::Result result =
+            optimizer.track(SymmetricMatrix(covariance), target, sectorMap);
+        
+        Matrix adjusted(weights.rows(), 1);
+        std::copy(result.weights.begin(), result.weights.end(), adjusted.begin());
+        return adjusted;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in adjustDiversification: " + std::string(e.what()));
+    }
+}
+
 double RiskConstraints::calculateTotalShortExposure(const Matrix& weights) {
     double totalShort = 0.0;
     for (int i = 0; i < weights.rows(); ++i) {
@@ -38,6 +38,7 @@ public:
         // Diversification
         int minPositions{10};             // Minimum number of positions
         int maxPositions{50};             // Maximum number of positions
+        bool enforceCardinality{false};   // enforceConstraints re-selects names (long only)
         
         ConstraintLimits() = default;
     };
@@ -63,7 +64,8 @@ public:
         ConstraintStatus() = default;
     };
 
-    explicit RiskConstraints(const ConstraintLimits& limits = ConstraintLimits());
+    RiskConstraints();
+    explicit RiskConstraints(const ConstraintLimits& limits);
     ~RiskConstraints() = default;
 
     // Main constraint checking methods
@@ -121,6 +123,14 @@ public:
         Matrix weights,
         const std::vector<double>& adv);
 
+    // Closest portfolio (in tracking error) to weights that holds between
+    // minPositions and maxPositions names within the position and sector
+    // limits. Long only: throws when minPositionSize allows shorts.
+    Matrix adjustDiversification(
+        const Matrix& weights,
+        const Matrix& covariance,
+        const std::map<int, std::string>& sectorMap);
+
     // Utility methods
     void setConstraintLimits(const ConstraintLimits& limits) { limits_ = limits; }
     ConstraintLimits getConstraintLimits() const { return limits_; }
@@ -1,4 +1,8 @@
 #include "RiskMetrics.hpp"
+#include "MatrixOperations.hpp"
+#include "DrawdownEngine.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -18,48 +22,95 @@ RiskMetrics::PortfolioRisk RiskMetrics::calculateRiskMetrics(
     double riskFreeRate) {
     
     try {
-        PortfolioRisk risk;
-        
-        // Calculate volatility metrics
-        risk.dailyVol = calculateVolatility(weights, covariance, false);
-        risk.monthlyVol = risk.dailyVol * sqrt(21);
-        risk.annualizedVol = risk.dailyVol * annualizationFactor_;
-        risk.trackingError = calculateTrackingError(weights, excessCovariance);
-        
-        // Calculate portfolio returns
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
-        double portfolioReturn = std::accumulate(portfolioReturns.begin(), 
-                                               portfolioReturns.end(), 0.0) / 
-                                               portfolioReturns.size();
-        
-        double excessReturn = portfolioReturn - riskFreeRate;
-        
-        // Calculate risk ratios
-        risk.beta = calculateBeta(weights, returns, benchmarkReturns);
-        risk.alpha = calculateAlpha(weights, returns, benchmarkReturns, riskFreeRate);
-        risk.informationRatio = calculateInformationRatio(excessReturn, risk.trackingError);
-        risk.sharpeRatio = calculateSharpeRatio(portfolioReturn, risk.dailyVol, riskFreeRate);
-        risk.sortino = calculateSortino(weights, returns, riskFreeRate);
-        risk.maxDrawdown = calculateMaxDrawdown(weights, returns);
-        risk.treynorRatio = calculateTreynorRatio(portfolioReturn, risk.beta, riskFreeRate);
-        
-        // Calculate VaR and Expected Shortfall
-        risk.valueAtRisk = calculateValueAtRisk(weights, returns, params_.confidenceLevel);
-        risk.expectedShortfall = calculateExpectedShortfall(weights, returns, params_.confidenceLevel);
-        
-        return risk;
+        PROFILE_SCOPE("risk_metrics");
+        ALLOCATION_SCOPE("risk_metrics");
+        return computeRiskMetrics(weights, calculatePortfolioReturns(weights, returns), covariance,
+                                  excessCovariance, benchmarkReturns, riskFreeRate);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateRiskMetrics: " + std::string(e.what()));
+    }
+}
+
+RiskMetrics::PortfolioRisk RiskMetrics::calculateRiskMetrics(
+    const DataWindow& window,
+    const Matrix& weights,
+    const Matrix& returns,
+    const Matrix& covariance,
+    const Matrix& excessCovariance,
+    const Matrix& benchmarkReturns,
+    double riskFreeRate) {
+    
+    try {
+        PROFILE_SCOPE("risk_metrics");
+        ALLOCATION_SCOPE("risk_metrics");
+        if (returns.rows() != window.numRows) {
+            throw std::runtime_error("returns do not match the data window");
+        }
+        return memoizedRiskMetrics(window, weights,
+                                   [&] { return calculatePortfolioReturns(weights, returns); },
+                                   covariance, excessCovariance, benchmarkReturns, riskFreeRate);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateRiskMetrics: " + std::string(e.what()));
+    }
+}
+
+RiskMetrics::PortfolioRisk RiskMetrics::calculateRiskMetrics(
+    const DataWindow& window,
+    const Matrix& weights,
+    const ReturnPanelF& returns,
+    const Matrix& covariance,
+    const Matrix& excessCovariance,
+    const Matrix& benchmarkReturns,
+    double riskFreeRate) {
+    
+    try {
+        PROFILE_SCOPE("risk_metrics");
+        ALLOCATION_SCOPE("risk_metrics");
+        return memoizedRiskMetrics(window, weights,
+                                   [&] { return calculatePortfolioReturns(weights, returns, window.firstRow,
+                                                                          window.numRows); },
+                                   covariance, excessCovariance, benchmarkReturns, riskFreeRate);
     }
     catch (const std::exception& e) {
         throw std::runtime_error("Error in calculateRiskMetrics: " + std::string(e.what()));
     }
 }
 
+std::vector<double> RiskMetrics::calculatePortfolioReturns(
+    const Matrix& weights,
+    const ReturnPanelF& returns,
+    Size firstRow,
+    Size numRows) {
+    
+    try {
+        if (weights.rows() != returns.columns()) {
+            throw std::runtime_error("Weights do not match return columns");
+        }
+        std::vector<double> portfolioReturns(numRows);
+        returns.portfolioReturns(weights.begin(), firstRow, numRows, portfolioReturns.data());
+        return portfolioReturns;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculatePortfolioReturns: " + std::string(e.what()));
+    }
+}
+
+void RiskMetrics::enableCache(size_t capacity) {
+    cache_ = std::make_unique<LRUCache<CacheKey, PortfolioRisk, CacheKeyHash>>(capacity);
+}
+
+RiskMetrics::CacheStatistics RiskMetrics::getCacheStatistics() const {
+    return cache_ ? cache_->statistics() : CacheStatistics();
+}
+
 double RiskMetrics::calculateTrackingError(
     const Matrix& weights, 
     const Matrix& excessCovariance) {
     
     try {
-        return sqrt((transpose(weights)*excessCovariance*weights)[0][0] * tradingDaysPerYear_);
+        return sqrt(MatrixOperations::quadForm(excessCovariance, weights) * tradingDaysPerYear_);
     }
     catch (const std::exception& e) {
         throw std::runtime_error("Error in calculateTrackingError: " + std::string(e.what()));
@@ -72,7 +123,33 @@ double RiskMetrics::calculateVolatility(
     bool isAnnualized) {
     
     try {
-        double vol = sqrt((transpose(weights)*covariance*weights)[0][0]);
+        double vol = sqrt(MatrixOperations::quadForm(covariance, weights));
+        return isAnnualized ? vol * annualizationFactor_ : vol;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateVolatility: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateTrackingError(
+    const Matrix& weights, 
+    const SymmetricMatrix& excessCovariance) {
+    
+    try {
+        return sqrt(MatrixOperations::quadForm(excessCovariance, weights) * tradingDaysPerYear_);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateTrackingError: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateVolatility(
+    const Matrix& weights,
+    const SymmetricMatrix& covariance,
+    bool isAnnualized) {
+    
+    try {
+        double vol = sqrt(MatrixOperations::quadForm(covariance, weights));
         return isAnnualized ? vol * annualizationFactor_ : vol;
     }
     catch (const std::exception& e) {
@@ -86,7 +163,18 @@ double RiskMetrics::calculateBeta(
     const Matrix& benchmarkReturns) {
     
     try {
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        return calculateBeta(calculatePortfolioReturns(weights, returns), benchmarkReturns);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateBeta: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateBeta(
+    const std::vector<double>& portfolioReturns,
+    const Matrix& benchmarkReturns) {
+    
+    try {
         double covar = 0.0, benchmarkVar = 0.0;
         double portfolioMean = 0.0, benchmarkMean = 0.0;
         
@@ -122,7 +210,19 @@ double RiskMetrics::calculateAlpha(
     double riskFreeRate) {
     
     try {
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        return calculateAlpha(calculatePortfolioReturns(weights, returns), benchmarkReturns, riskFreeRate);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateAlpha: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateAlpha(
+    const std::vector<double>& portfolioReturns,
+    const Matrix& benchmarkReturns,
+    double riskFreeRate) {
+    
+    try {
         double portfolioReturn = std::accumulate(portfolioReturns.begin(), 
                                                portfolioReturns.end(), 0.0) / 
                                                portfolioReturns.size();
@@ -133,7 +233,7 @@ double RiskMetrics::calculateAlpha(
         }
         benchmarkReturn /= benchmarkReturns.rows();
         
-        double beta = calculateBeta(weights, returns, benchmarkReturns);
+        double beta = calculateBeta(portfolioReturns, benchmarkReturns);
         
         return portfolioReturn - (riskFreeRate + beta * (benchmarkReturn - riskFreeRate));
     }
@@ -148,17 +248,7 @@ double RiskMetrics::calculateMaxDrawdown(
     
     try {
         auto portfolioReturns = calculatePortfolioReturns(weights, returns);
-        double maxDrawdown = 0.0;
-        double peak = 1.0;
-        double value = 1.0;
-        
-        for (double ret : portfolioReturns) {
-            value *= (1 + ret);
-            peak = std::max(peak, value);
-            maxDrawdown = std::min(maxDrawdown, value / peak - 1);
-        }
-        
-        return -maxDrawdown;  // Return positive value
+        return DrawdownEngine::maxDrawdown(portfolioReturns);  // Positive value
     }
     catch (const std::exception& e) {
         throw std::runtime_error("Error in calculateMaxDrawdown: " + std::string(e.what()));
@@ -192,8 +282,19 @@ double RiskMetrics::calculateSortino(
     double targetReturn) {
     
     try {
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
-        double downsideDeviation = calculateDownsideDeviation(weights, returns, targetReturn);
+        return calculateSortino(calculatePortfolioReturns(weights, returns), targetReturn);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateSortino: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateSortino(
+    const std::vector<double>& portfolioReturns,
+    double targetReturn) {
+    
+    try {
+        double downsideDeviation = calculateDownsideDeviation(portfolioReturns, targetReturn);
         
         double averageReturn = std::accumulate(portfolioReturns.begin(), 
                                              portfolioReturns.end(), 0.0) / 
@@ -227,7 +328,18 @@ double RiskMetrics::calculateValueAtRisk(
     double confidenceLevel) {
     
     try {
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        return calculateValueAtRisk(calculatePortfolioReturns(weights, returns), confidenceLevel);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateValueAtRisk: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateValueAtRisk(
+    std::vector<double> portfolioReturns,
+    double confidenceLevel) {
+    
+    try {
         std::sort(portfolioReturns.begin(), portfolioReturns.end());
         
         size_t index = static_cast<size_t>((1 - confidenceLevel) * portfolioReturns.size());
@@ -244,7 +356,18 @@ double RiskMetrics::calculateExpectedShortfall(
     double confidenceLevel) {
     
     try {
-        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        return calculateExpectedShortfall(calculatePortfolioReturns(weights, returns), confidenceLevel);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateExpectedShortfall: " + std::string(e.what()));
+    }
+}
+
+double RiskMetrics::calculateExpectedShortfall(
+    std::vector<double> portfolioReturns,
+    double confidenceLevel) {
+    
+    try {
         std::sort(portfolioReturns.begin(), portfolioReturns.end());
         
         size_t cutoff = static_cast<size_t>((1 - confidenceLevel) * portfolioReturns.size());
@@ -263,17 +386,39 @@ double RiskMetrics::calculateExpectedShortfall(
 
 std::map<std::string, double> RiskMetrics::calculateFactorExposures(
     const Matrix& weights,
+    const Matrix& assetReturns,
     const Matrix& factorReturns,
     const std::vector<std::string>& factorNames) {
     
     try {
+        if (factorReturns.rows() != assetReturns.rows()) {
+            throw std::runtime_error("factor returns do not match the asset returns");
+        }
         std::map<std::string, double> exposures;
-        Matrix factorBetas = calculateRollingBeta(factorReturns, 
-                                                factorReturns, 
-                                                factorReturns.rows());
         
-        for (size_t i = 0; i < factorNames.size(); ++i) {
-            exposures[factorNames[i]] = (transpose(weights) * factorBetas)[0][i];
+        // Full-sample beta of the portfolio series to each factor column;
+        // the series is built once
+        auto portfolioReturns = calculatePortfolioReturns(weights, assetReturns);
+        const Size T = portfolioReturns.size();
+        if (T < 2) {
+            throw std::runtime_error("need at least two return rows");
+        }
+        double portfolioMean = 0.0;
+        for (double r : portfolioReturns) portfolioMean += r;
+        portfolioMean /= T;
+        
+        for (size_t k = 0; k < factorNames.size() && k < factorReturns.columns(); ++k) {
+            double factorMean = 0.0;
+            for (Size t = 0; t < T; ++t) factorMean += factorReturns[t][k];
+            factorMean /= T;
+            
+            double covar = 0.0, factorVar = 0.0;
+            for (Size t = 0; t < T; ++t) {
+                double f = factorReturns[t][k] - factorMean;
+                covar += (portfolioReturns[t] - portfolioMean) * f;
+                factorVar += f * f;
+            }
+            exposures[factorNames[k]] = covar / factorVar;
         }
         
         return exposures;
@@ -288,8 +433,36 @@ Matrix RiskMetrics::calculateRiskContribution(
     const Matrix& covariance) {
     
     try {
-        Matrix portfolioVol = sqrt((transpose(weights)*covariance*weights));
-        return multiply(covariance*weights, weights) / portfolioVol[0][0];
+        // RC_i = w_i (Sigma w)_i / sigma, built in place from one symv
+        Matrix contribution(weights.rows(), 1);
+        MatrixOperations::symv(covariance, weights, contribution);
+        double portfolioVol = sqrt(MatrixOperations::dot(
+            weights.begin(), contribution.begin(), weights.rows()));
+        
+        for (Size i = 0; i < weights.rows(); ++i) {
+            contribution[i][0] *= weights[i][0] / portfolioVol;
+        }
+        return contribution;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateRiskContribution: " + std::string(e.what()));
+    }
+}
+
+Matrix RiskMetrics::calculateRiskContribution(
+    const Matrix& weights,
+    const SymmetricMatrix& covariance) {
+    
+    try {
+        Matrix contribution(weights.rows(), 1);
+        MatrixOperations::symv(covariance, weights, contribution);
+        double portfolioVol = sqrt(MatrixOperations::dot(
+            weights.begin(), contribution.begin(), weights.rows()));
+        
+        for (Size i = 0; i < weights.rows(); ++i) {
+            contribution[i][0] *= weights[i][0] / portfolioVol;
+        }
+        return contribution;
     }
     catch (const std::exception& e) {
         throw std::runtime_error("Error in calculateRiskContribution: " + std::string(e.what()));
@@ -312,20 +485,17 @@ Matrix RiskMetrics::calculateComponentVaR(
 }
 
 Matrix RiskMetrics::calculateRollingBeta(
+    const Matrix& weights,
     const Matrix& returns,
     const Matrix& benchmarkReturns,
     int windowSize) {
     
     try {
-        int numPeriods = returns.rows() - windowSize + 1;
-        Matrix rollingBetas(numPeriods, 1);
-        
-        for (int i = 0; i < numPeriods; ++i) {
-            Matrix windowReturns = returns.block(i, 0, windowSize, returns.columns());
-            Matrix windowBenchmark = benchmarkReturns.block(i, 0, windowSize, 1);
-            rollingBetas[i][0] = calculateBeta(weights, windowReturns, windowBenchmark);
+        Matrix rolling = calculateRollingMetrics(weights, returns, benchmarkReturns, windowSize);
+        Matrix rollingBetas(returns.rows() - windowSize + 1, 1);
+        for (Size i = 0; i < rollingBetas.rows(); ++i) {
+            rollingBetas[i][0] = rolling[i + windowSize - 1][RollingAnalytics::BETA];
         }
-        
         return rollingBetas;
     }
     catch (const std::exception& e) {
@@ -334,18 +504,17 @@ Matrix RiskMetrics::calculateRollingBeta(
 }
 
 Matrix RiskMetrics::calculateRollingVolatility(
+    const Matrix& weights,
     const Matrix& returns,
     int windowSize) {
     
     try {
-        int numPeriods = returns.rows() - windowSize + 1;
-        Matrix rollingVol(numPeriods, 1);
-        
-        for (int i = 0; i < numPeriods; ++i) {
-            Matrix windowReturns = returns.block(i, 0, windowSize, returns.columns());
-            rollingVol[i][0] = calculateVolatility(weights, windowReturns, true);
+        Matrix benchmark(returns.rows(), 1, 0.0);
+        Matrix rolling = calculateRollingMetrics(weights, returns, benchmark, windowSize);
+        Matrix rollingVol(returns.rows() - windowSize + 1, 1);
+        for (Size i = 0; i < rollingVol.rows(); ++i) {
+            rollingVol[i][0] = rolling[i + windowSize - 1][RollingAnalytics::VOLATILITY];
         }
-        
         return rollingVol;
     }
     catch (const std::exception& e) {
@@ -353,13 +522,117 @@ Matrix RiskMetrics::calculateRollingVolatility(
     }
 }
 
+Matrix RiskMetrics::calculateRollingMetrics(
+    const Matrix& weights,
+    const Matrix& returns,
+    const Matrix& benchmarkReturns,
+    int windowSize,
+    double riskFreeRate) {
+    
+    try {
+        if (windowSize < 2 || static_cast<Size>(windowSize) > returns.rows()) {
+            throw std::runtime_error("Window size must be between 2 and the number of return rows");
+        }
+        if (benchmarkReturns.rows() != returns.rows()) {
+            throw std::runtime_error("Benchmark length does not match returns");
+        }
+        
+        RollingAnalytics::RollingParameters parameters;
+        parameters.windowSize = windowSize;
+        parameters.riskFreeRate = riskFreeRate;
+        parameters.targetReturn = params_.targetReturn;
+        parameters.tradingDaysPerYear = tradingDaysPerYear_;
+        
+        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        std::vector<double> benchmark(benchmarkReturns.rows());
+        for (Size i = 0; i < benchmarkReturns.rows(); ++i) {
+            benchmark[i] = benchmarkReturns[i][0];
+        }
+        return RollingAnalytics::compute(portfolioReturns, benchmark, parameters);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateRollingMetrics: " + std::string(e.what()));
+    }
+}
+
 // Private helper methods
+RiskMetrics::PortfolioRisk RiskMetrics::computeRiskMetrics(
+    const Matrix& weights,
+    const std::vector<double>& portfolioReturns,
+    const Matrix& covariance,
+    const Matrix& excessCovariance,
+    const Matrix& benchmarkReturns,
+    double riskFreeRate) {
+    
+    PortfolioRisk risk;
+    
+    // Calculate volatility metrics
+    risk.dailyVol = calculateVolatility(weights, covariance, false);
+    risk.monthlyVol = risk.dailyVol * sqrt(21);
+    risk.annualizedVol = risk.dailyVol * annualizationFactor_;
+    risk.trackingError = calculateTrackingError(weights, excessCovariance);
+    
+    // Every return-based measure reads the one portfolio series
+    double portfolioReturn = std::accumulate(portfolioReturns.begin(), 
+                                           portfolioReturns.end(), 0.0) / 
+                                           portfolioReturns.size();
+    
+    double excessReturn = portfolioReturn - riskFreeRate;
+    
+    // Calculate risk ratios
+    risk.beta = calculateBeta(portfolioReturns, benchmarkReturns);
+    risk.alpha = calculateAlpha(portfolioReturns, benchmarkReturns, riskFreeRate);
+    risk.informationRatio = calculateInformationRatio(excessReturn, risk.trackingError);
+    risk.sharpeRatio = calculateSharpeRatio(portfolioReturn, risk.dailyVol, riskFreeRate);
+    risk.sortino = calculateSortino(portfolioReturns, riskFreeRate);
+    risk.maxDrawdown = DrawdownEngine::maxDrawdown(portfolioReturns);
+    risk.treynorRatio = calculateTreynorRatio(portfolioReturn, risk.beta, riskFreeRate);
+    
+    // Calculate VaR and Expected Shortfall
+    risk.valueAtRisk = calculateValueAtRisk(portfolioReturns, params_.confidenceLevel);
+    risk.expectedShortfall = calculateExpectedShortfall(portfolioReturns, params_.confidenceLevel);
+    
+    return risk;
+}
+
+RiskMetrics::PortfolioRisk RiskMetrics::memoizedRiskMetrics(
+    const DataWindow& window,
+    const Matrix& weights,
+    const std::function<std::vector<double>()>& portfolioReturns,
+    const Matrix& covariance,
+    const Matrix& excessCovariance,
+    const Matrix& benchmarkReturns,
+    double riskFreeRate) {
+    
+    CacheKey key;
+    if (cache_) {
+        key = makeCacheKey(window, weights, riskFreeRate);
+        if (const PortfolioRisk* cached = cache_->find(key)) {
+            PROFILE_COUNT("risk_metrics.cache_hits", 1);
+            return *cached;
+        }
+    }
+    
+    PortfolioRisk risk = computeRiskMetrics(weights, portfolioReturns(), covariance,
+                                            excessCovariance, benchmarkReturns, riskFreeRate);
+    if (cache_) {
+        cache_->insert(key, risk);
+    }
+    return risk;
+}
+
 double RiskMetrics::calculateDownsideDeviation(
     const Matrix& weights,
     const Matrix& returns,
     double targetReturn) {
     
-    auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+    return calculateDownsideDeviation(calculatePortfolioReturns(weights, returns), targetReturn);
+}
+
+double RiskMetrics::calculateDownsideDeviation(
+    const std::vector<double>& portfolioReturns,
+    double targetReturn) {
+    
     double sumSquaredDownside = 0.0;
     int count = 0;
     
@@ -377,20 +650,48 @@ std::vector<double> RiskMetrics::calculatePortfolioReturns(
     const Matrix& weights,
     const Matrix& returns) {
     
-    std::vector<double> portfolioReturns;
-    portfolioReturns.reserve(returns.rows());
+    if (weights.rows() != returns.columns()) {
+        throw std::runtime_error("Weights do not match return columns");
+    }
+    
+    std::vector<double> portfolioReturns(returns.rows());
+    MatrixOperations::gemv(returns, weights.begin(), portfolioReturns.data());
     
-    for (int i = 0; i < returns.rows(); ++i) {
-        double dailyReturn = 0.0;
-        for (int j = 0; j < returns.columns(); ++j) {
-            dailyReturn += weights[j][0] * returns[i][j];
+    // Rows with missing (NaN) cells: unobserved assets contribute a zero return
+    for (Size t = 0; t < returns.rows(); ++t) {
+        if (std::isnan(portfolioReturns[t])) {
+            double sum = 0.0;
+            for (Size j = 0; j < returns.columns(); ++j) {
+                if (!std::isnan(returns[t][j])) sum += weights[j][0] * returns[t][j];
+            }
+            portfolioReturns[t] = sum;
         }
-        portfolioReturns.push_back(dailyReturn);
     }
     
     return portfolioReturns;
 }
 
+BlockBootstrap::MetricIntervals RiskMetrics::calculateMetricIntervals(
+    const Matrix& weights,
+    const Matrix& returns,
+    const Matrix& benchmarkReturns,
+    const BlockBootstrap::BootstrapParameters& parameters) {
+    
+    try {
+        if (benchmarkReturns.rows() != returns.rows()) {
+            throw std::runtime_error("Benchmark returns do not match the return panel");
+        }
+        auto portfolioReturns = calculatePortfolioReturns(weights, returns);
+        std::vector<double> benchmark(benchmarkReturns.begin(), benchmarkReturns.begin() + benchmarkReturns.rows());
+        
+        BlockBootstrap bootstrap(parameters);
+        return bootstrap.run(portfolioReturns, benchmark);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in calculateMetricIntervals: " + std::string(e.what()));
+    }
+}
+
 Matrix RiskMetrics::calculateExponentialCovariance(
     const Matrix& returns,
     double lambda) {
@@ -427,4 +728,26 @@ double RiskMetrics::calculateParametricVaR(
     // Using normal distribution approximation
     double z = InverseCumulativeNormal()(confidenceLevel);
     return -(mean + z * stddev);  // Return positive value
-}
\ No newline at end of file
+}
+
+RiskMetrics::CacheKey RiskMetrics::makeCacheKey(
+    const DataWindow& window,
+    const Matrix& weights,
+    double riskFreeRate) const {
+    
+    CacheKey key;
+    key.weights = MemoHash::doubles(weights.begin(), weights.rows() * weights.columns(), weights.rows());
+    key.window = MemoHash::combine(MemoHash::combine(window.version, window.firstRow), window.numRows);
+    
+    const double parameters[] = {
+        params_.confidenceLevel,
+        static_cast<double>(params_.varHorizon),
+        params_.targetReturn,
+        params_.useExponentialWeighting ? 1.0 : 0.0,
+        params_.decayFactor,
+        annualizationFactor_,
+        riskFreeRate
+    };
+    key.parameters = MemoHash::doubles(parameters, sizeof(parameters) / sizeof(parameters[0]));
+    return key;
+}
@@ -1,10 +1,16 @@
 #pragma once
 #include <ql/quantlib.hpp>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <string>
 #include <map>
 #include <stdexcept>
+#include "SymmetricMatrix.hpp"
+#include "ReturnPanel.hpp"
+#include "LRUCache.hpp"
+#include "BlockBootstrap.hpp"
+#include "RollingAnalytics.hpp"
 
 using namespace QuantLib;
 
@@ -39,6 +45,42 @@ public:
         RiskParameters() = default;
     };
 
+    // Identity of the data behind a call, supplied by the caller: a version
+    // it bumps whenever rows already handed out change (reload, precision
+    // switch), plus the row range. Append-only storage keeps old ranges
+    // valid, so a new day only moves the range.
+    struct DataWindow {
+        uint64_t version{0};
+        Size firstRow{0};
+        Size numRows{0};
+
+        DataWindow() = default;
+        DataWindow(uint64_t v, Size first, Size rows) : version(v), firstRow(first), numRows(rows) {}
+    };
+
+    // Identity of one memoized calculateRiskMetrics call: a hash of the
+    // weights, the caller's window identity and the parameters in effect.
+    // The data itself is never hashed.
+    struct CacheKey {
+        uint64_t weights{0};
+        uint64_t window{0};
+        uint64_t parameters{0};
+
+        bool operator==(const CacheKey& other) const {
+            return weights == other.weights && window == other.window &&
+                   parameters == other.parameters;
+        }
+    };
+
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey& key) const {
+            return static_cast<size_t>(MemoHash::combine(MemoHash::combine(key.weights, key.window),
+                                                         key.parameters));
+        }
+    };
+
+    using CacheStatistics = LRUCache<CacheKey, PortfolioRisk, CacheKeyHash>::Statistics;
+
     explicit RiskMetrics(int tradingDaysPerYear = 252);
     ~RiskMetrics() = default;
 
@@ -52,6 +94,39 @@ public:
         const Matrix& benchmarkReturns,
         double riskFreeRate = 0.0);
 
+    // Same metrics over the rows `window` identifies; memoized when the
+    // cache is enabled. returns and benchmarkReturns hold those rows, and
+    // the covariances are estimated from them.
+    PortfolioRisk calculateRiskMetrics(
+        const DataWindow& window,
+        const Matrix& weights,
+        const Matrix& returns,
+        const Matrix& covariance,
+        const Matrix& excessCovariance,
+        const Matrix& benchmarkReturns,
+        double riskFreeRate = 0.0);
+
+    // Opt-in single precision: the window is read in place from a float32
+    // panel, rows [window.firstRow, window.firstRow + window.numRows). The
+    // portfolio series accumulates in double, so each return is within
+    // 2^-24 * sum_j |w_j| |x_tj| of the double path (see ReturnPanel.hpp).
+    PortfolioRisk calculateRiskMetrics(
+        const DataWindow& window,
+        const Matrix& weights,
+        const ReturnPanelF& returns,
+        const Matrix& covariance,
+        const Matrix& excessCovariance,
+        const Matrix& benchmarkReturns,
+        double riskFreeRate = 0.0);
+
+    // Portfolio return series from rows of a float32 panel (float64
+    // accumulation); missing cells count as a zero return
+    std::vector<double> calculatePortfolioReturns(
+        const Matrix& weights,
+        const ReturnPanelF& returns,
+        Size firstRow,
+        Size numRows);
+
     // Individual risk measures
     double calculateTrackingError(
         const Matrix& weights, 
@@ -62,6 +137,16 @@ public:
         const Matrix& covariance,
         bool isAnnualized = false);
 
+    // Packed covariance variants
+    double calculateTrackingError(
+        const Matrix& weights, 
+        const SymmetricMatrix& excessCovariance);
+
+    double calculateVolatility(
+        const Matrix& weights, 
+        const SymmetricMatrix& covariance,
+        bool isAnnualized = false);
+
     double calculateBeta(
         const Matrix& weights,
         const Matrix& returns,
@@ -106,9 +191,11 @@ public:
         const Matrix& returns,
         double confidenceLevel = 0.95);
 
-    // Factor analysis
+    // Factor analysis: beta of the portfolio series w'R (assetReturns T x N)
+    // to each factor column (factorReturns T x K, same rows)
     std::map<std::string, double> calculateFactorExposures(
         const Matrix& weights,
+        const Matrix& assetReturns,
         const Matrix& factorReturns,
         const std::vector<std::string>& factorNames);
 
@@ -117,21 +204,53 @@ public:
         const Matrix& weights,
         const Matrix& covariance);
 
+    Matrix calculateRiskContribution(
+        const Matrix& weights,
+        const SymmetricMatrix& covariance);
+
     Matrix calculateComponentVaR(
         const Matrix& weights,
         const Matrix& returns,
         double confidenceLevel = 0.95);
 
-    // Rolling analysis
+    // Rolling analysis over chronological rows; one row per full window
+    // (T - windowSize + 1), volatility annualized
     Matrix calculateRollingBeta(
+        const Matrix& weights,
         const Matrix& returns,
         const Matrix& benchmarkReturns,
         int windowSize);
 
     Matrix calculateRollingVolatility(
+        const Matrix& weights,
         const Matrix& returns,
         int windowSize);
 
+    // Every RollingAnalytics metric: T x METRIC_COUNT, NaN before the first
+    // full window
+    Matrix calculateRollingMetrics(
+        const Matrix& weights,
+        const Matrix& returns,
+        const Matrix& benchmarkReturns,
+        int windowSize,
+        double riskFreeRate = 0.0);
+
+    // Stationary block bootstrap intervals for Sharpe, Sortino, IR and max
+    // drawdown; rows of returns must be chronological
+    BlockBootstrap::MetricIntervals calculateMetricIntervals(
+        const Matrix& weights,
+        const Matrix& returns,
+        const Matrix& benchmarkReturns,
+        const BlockBootstrap::BootstrapParameters& parameters = BlockBootstrap::BootstrapParameters());
+
+    // Opt-in memoization of the DataWindow calculateRiskMetrics, bounded to
+    // `capacity` results with least-recently-used eviction. A lookup hashes
+    // only the weights and parameters (O(N)), never the data.
+    void enableCache(size_t capacity = 256);
+    void disableCache() { cache_.reset(); }
+    void clearCache() { if (cache_) cache_->clear(); }
+    CacheStatistics getCacheStatistics() const;
+
     // Utility methods
     void setRiskParameters(const RiskParameters& params) { params_ = params; }
     RiskParameters getRiskParameters() const { return params_; }
@@ -142,8 +261,60 @@ private:
     int tradingDaysPerYear_;
     double annualizationFactor_;
     RiskParameters params_;
+    std::unique_ptr<LRUCache<CacheKey, PortfolioRisk, CacheKeyHash>> cache_;
 
     // Helper methods
+    PortfolioRisk computeRiskMetrics(
+        const Matrix& weights,
+        const std::vector<double>& portfolioReturns,
+        const Matrix& covariance,
+        const Matrix& excessCovariance,
+        const Matrix& benchmarkReturns,
+        double riskFreeRate);
+
+    // Cache lookup for the DataWindow overloads; the series is only built on
+    // a miss
+    PortfolioRisk memoizedRiskMetrics(
+        const DataWindow& window,
+        const Matrix& weights,
+        const std::function<std::vector<double>()>& portfolioReturns,
+        const Matrix& covariance,
+        const Matrix& excessCovariance,
+        const Matrix& benchmarkReturns,
+        double riskFreeRate);
+
+    // Series-based measures shared by calculateRiskMetrics and the
+    // weights/returns overloads above
+    double calculateBeta(
+        const std::vector<double>& portfolioReturns,
+        const Matrix& benchmarkReturns);
+
+    double calculateAlpha(
+        const std::vector<double>& portfolioReturns,
+        const Matrix& benchmarkReturns,
+        double riskFreeRate);
+
+    double calculateSortino(
+        const std::vector<double>& portfolioReturns,
+        double targetReturn);
+
+    double calculateValueAtRisk(
+        std::vector<double> portfolioReturns,
+        double confidenceLevel);
+
+    double calculateExpectedShortfall(
+        std::vector<double> portfolioReturns,
+        double confidenceLevel);
+
+    double calculateDownsideDeviation(
+        const std::vector<double>& portfolioReturns,
+        double targetReturn);
+
+    CacheKey makeCacheKey(
+        const DataWindow& window,
+        const Matrix& weights,
+        double riskFreeRate) const;
+
     double calculateDownsideDeviation(
         const Matrix& weights,
         const Matrix& returns,
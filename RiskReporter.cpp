@@ -1,53 +1,82 @@
 #include "RiskReporter.hpp"
+#include "Profiler.hpp"
+#include <cmath>
+#include <vector>
 
 void RiskReporter::generateDetailedReport(
     const std::string& filename,
     const RiskMetrics::PortfolioRisk& risk,
     const Matrix& weights,
-    const Matrix& returns) {
+    const Matrix& returns,
+    AsyncFileWriter* writer) {
     
-    std::ofstream report(filename);
-    if (!report.is_open()) {
-        throw std::runtime_error("Unable to open report file: " + filename);
-    }
-
-    report << std::fixed << std::setprecision(PRECISION);
-    
-    // Portfolio Statistics
-    report << "Portfolio Statistics\n";
-    report << "===================\n\n";
+    PROFILE_SCOPE("report.detailed");
     
-    // Portfolio Composition
-    report << "Portfolio Composition:\n";
-    report << "---------------------\n";
-    double totalWeight = 0.0;
+    // Calculations stay on the caller; the job only formats a snapshot
+    std::vector<double> weightValues(weights.rows());
     for (Size i = 0; i < weights.rows(); ++i) {
-        report << "Asset " << i+1 << ": " << weights[i][0] * 100 << "%\n";
-        totalWeight += weights[i][0];
+        weightValues[i] = weights[i][0];
     }
-    report << "Total Weight: " << totalWeight * 100 << "%\n\n";
-    
-    // Risk Metrics
-    report << "Risk Metrics:\n";
-    report << "-------------\n";
-    report << "Value at Risk (95%):    " << risk.var95 * 100 << "%\n";
-    report << "Conditional VaR (95%):  " << risk.cvar95 * 100 << "%\n";
-    report << "Sharpe Ratio:           " << risk.sharpeRatio << "\n";
-    report << "Beta:                   " << risk.beta << "\n";
-    report << "Information Ratio:      " << risk.informationRatio << "\n";
-    report << "Maximum Drawdown:       " << risk.maxDrawdown * 100 << "%\n";
-    report << "Sortino Ratio:         " << risk.sortino << "\n\n";
-    
-    // Performance Analysis
-    report << "Performance Analysis:\n";
-    report << "--------------------\n";
     double annualizedReturn = calculateAnnualizedReturn(returns, weights);
     double annualizedVol = calculateAnnualizedVolatility(returns, weights);
     
-    report << "Annualized Return:      " << annualizedReturn * 100 << "%\n";
-    report << "Annualized Volatility:  " << annualizedVol * 100 << "%\n";
+    auto format = [risk, weightValues, annualizedReturn, annualizedVol](TextBuffer& report) {
+        auto percent = [&report](double value) -> TextBuffer& {
+            return report.fixed(value * 100, PRECISION) << "%\n";
+        };
+        auto number = [&report](double value) -> TextBuffer& {
+            return report.fixed(value, PRECISION) << "\n";
+        };
+        
+        // Portfolio Statistics
+        report << "Portfolio Statistics\n";
+        report << "===================\n\n";
+        
+        // Portfolio Composition
+        report << "Portfolio Composition:\n";
+        report << "---------------------\n";
+        double totalWeight = 0.0;
+        for (size_t i = 0; i < weightValues.size(); ++i) {
+            report << "Asset ";
+            report.integer(static_cast<long long>(i + 1)) << ": ";
+            percent(weightValues[i]);
+            totalWeight += weightValues[i];
+        }
+        report << "Total Weight: "; percent(totalWeight);
+        report << "\n";
+        
+        // Risk Metrics
+        report << "Risk Metrics:\n";
+        report << "-------------\n";
+        report << "Value at Risk (95%):    "; percent(risk.valueAtRisk);
+        report << "Conditional VaR (95%):  "; percent(risk.expectedShortfall);
+        report << "Sharpe Ratio:           "; number(risk.sharpeRatio);
+        report << "Beta:                   "; number(risk.beta);
+        report << "Information Ratio:      "; number(risk.informationRatio);
+        report << "Maximum Drawdown:       "; percent(risk.maxDrawdown);
+        report << "Sortino Ratio:         "; number(risk.sortino);
+        report << "\n";
+        
+        // Performance Analysis
+        report << "Performance Analysis:\n";
+        report << "--------------------\n";
+        report << "Annualized Return:      "; percent(annualizedReturn);
+        report << "Annualized Volatility:  "; percent(annualizedVol);
+    };
     
-    report.close();
+    if (writer) {
+        writer->submit(filename, format);
+        return;
+    }
+    
+    TextBuffer report;
+    format(report);
+    try {
+        AsyncFileWriter::writeFile(filename, report);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Unable to write report file: " + std::string(e.what()));
+    }
 }
 
 double RiskReporter::calculateAnnualizedReturn(
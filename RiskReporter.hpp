@@ -1,16 +1,17 @@
 #pragma once
 #include "RiskMetrics.hpp"
-#include <fstream>
-#include <iomanip>
+#include "AsyncWriter.hpp"
 #include <stdexcept>
 
 class RiskReporter {
 public:
-    // Main report generation methods
+    // Main report generation methods. With a writer the report is formatted
+    // and written on its background thread; otherwise it is written inline.
     static void generateDetailedReport(const std::string& filename,
                                      const RiskMetrics::PortfolioRisk& risk,
                                      const Matrix& weights,
-                                     const Matrix& returns);
+                                     const Matrix& returns,
+                                     AsyncFileWriter* writer = nullptr);
 
 private:
     // Helper methods for calculations
@@ -0,0 +1,211 @@
+#include "RollingAnalytics.hpp"
+#include "MatrixOperations.hpp"
+#include "Profiler.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+RollingAnalytics::RollingAnalytics(size_t numPortfolios)
+    : RollingAnalytics(numPortfolios, RollingParameters()) {}
+
+RollingAnalytics::RollingAnalytics(size_t numPortfolios, const RollingParameters& parameters)
+    : parameters_(parameters)
+    , numPortfolios_(numPortfolios)
+    , window_(parameters.windowSize > 0 ? static_cast<size_t>(parameters.windowSize) : 0)
+    , scale_(parameters.annualize ? std::sqrt(static_cast<double>(parameters.tradingDaysPerYear)) : 1.0)
+    , history_(window_ * numPortfolios)
+    , benchmarkHistory_(window_)
+    , shift_(numPortfolios, 0.0)
+    , sum_(numPortfolios, 0.0)
+    , sumSquares_(numPortfolios, 0.0)
+    , crossProducts_(numPortfolios, 0.0)
+    , downsideSquares_(numPortfolios, 0.0)
+    , downsideCount_(numPortfolios, 0.0) {
+
+    if (parameters.windowSize < 2) {
+        throw std::runtime_error("RollingAnalytics: window size must be at least 2");
+    }
+}
+
+void RollingAnalytics::append(const double* portfolioReturns, double benchmarkReturn) {
+    size_t slot = count_ < window_ ? count_ : head_;
+    double* row = history_.data() + slot * numPortfolios_;
+    double benchmark = std::isnan(benchmarkReturn) ? 0.0 : benchmarkReturn;
+
+    if (count_ == 0) {
+        for (size_t p = 0; p < numPortfolios_; ++p) {
+            shift_[p] = std::isnan(portfolioReturns[p]) ? 0.0 : portfolioReturns[p];
+        }
+        benchmarkShift_ = benchmark;
+    }
+
+    // Retire the oldest row, then store and add the new one in its slot
+    if (count_ >= window_) {
+        accumulate(row, benchmarkHistory_[slot], -1.0);
+        head_ = (head_ + 1) % window_;
+    }
+    for (size_t p = 0; p < numPortfolios_; ++p) {
+        row[p] = std::isnan(portfolioReturns[p]) ? 0.0 : portfolioReturns[p];
+    }
+    benchmarkHistory_[slot] = benchmark;
+    accumulate(row, benchmark, 1.0);
+    ++count_;
+
+    if (count_ > window_ && head_ == 0) {
+        rebuild();
+    }
+}
+
+void RollingAnalytics::reset() {
+    count_ = 0;
+    head_ = 0;
+    clearSums();
+}
+
+double RollingAnalytics::metric(size_t portfolio, Metric metric) const {
+    double values[METRIC_COUNT];
+    metrics(portfolio, values);
+    return values[metric];
+}
+
+void RollingAnalytics::metrics(size_t portfolio, double* out) const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (!ready()) {
+        std::fill(out, out + METRIC_COUNT, nan);
+        return;
+    }
+
+    const size_t p = portfolio;
+    const double n = static_cast<double>(window_);
+    double variance = std::max(0.0, (sumSquares_[p] - sum_[p] * sum_[p] / n) / (n - 1.0));
+    double benchmarkVariance = std::max(0.0, (benchmarkSquares_ - benchmarkSum_ * benchmarkSum_ / n) / (n - 1.0));
+    double covariance = (crossProducts_[p] - sum_[p] * benchmarkSum_ / n) / (n - 1.0);
+    double activeVariance = std::max(0.0, variance + benchmarkVariance - 2.0 * covariance);
+    double mean = sum_[p] / n + shift_[p];
+    double sd = std::sqrt(variance);
+
+    out[VOLATILITY] = sd * scale_;
+    out[BETA] = benchmarkVariance > 0.0 ? covariance / benchmarkVariance : nan;
+    out[TRACKING_ERROR] = std::sqrt(activeVariance) * scale_;
+    out[SHARPE] = sd > 0.0 ? (mean - parameters_.riskFreeRate) / sd * scale_ : nan;
+
+    double downsideDays = std::round(downsideCount_[p]);
+    double downside = downsideDays > 0.0 ? std::sqrt(std::max(0.0, downsideSquares_[p]) / downsideDays) : 0.0;
+    out[SORTINO] = downside > 0.0 ? (mean - parameters_.targetReturn) / downside * scale_ : nan;
+}
+
+std::vector<Matrix> RollingAnalytics::compute(const Matrix& portfolioReturns,
+                                              const std::vector<double>& benchmarkReturns,
+                                              const RollingParameters& parameters) {
+    try {
+        PROFILE_SCOPE("rolling_analytics");
+        const Size T = portfolioReturns.rows();
+        const Size P = portfolioReturns.columns();
+        if (benchmarkReturns.size() != T) {
+            throw std::runtime_error("benchmark length does not match the return panel");
+        }
+
+        std::vector<Matrix> outputs(METRIC_COUNT, Matrix(T, P));
+        WorkStealingPool pool(parameters.numThreads);
+        size_t blocks = (P + BLOCK - 1) / BLOCK;
+        pool.parallelFor(blocks, [&](size_t block, size_t) {
+            size_t first = block * BLOCK;
+            size_t count = std::min(BLOCK, P - first);
+            RollingAnalytics state(count, parameters);
+            double values[METRIC_COUNT];
+            for (Size t = 0; t < T; ++t) {
+                state.append(portfolioReturns[t] + first, benchmarkReturns[t]);
+                for (size_t p = 0; p < count; ++p) {
+                    state.metrics(p, values);
+                    for (int m = 0; m < METRIC_COUNT; ++m) {
+                        outputs[m][t][first + p] = values[m];
+                    }
+                }
+            }
+        });
+        return outputs;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in RollingAnalytics::compute: " + std::string(e.what()));
+    }
+}
+
+Matrix RollingAnalytics::compute(const std::vector<double>& portfolioReturns,
+                                 const std::vector<double>& benchmarkReturns,
+                                 const RollingParameters& parameters) {
+    Matrix panel(portfolioReturns.size(), 1);
+    std::copy(portfolioReturns.begin(), portfolioReturns.end(), panel.begin());
+    std::vector<Matrix> outputs = compute(panel, benchmarkReturns, parameters);
+
+    Matrix result(portfolioReturns.size(), METRIC_COUNT);
+    for (Size t = 0; t < result.rows(); ++t) {
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            result[t][m] = outputs[m][t][0];
+        }
+    }
+    return result;
+}
+
+Matrix RollingAnalytics::portfolioReturns(const Matrix& weights, const Matrix& returns) {
+    if (weights.rows() != returns.columns()) {
+        throw std::runtime_error("RollingAnalytics: weights do not match return columns");
+    }
+    const Size P = weights.columns();
+    Matrix result(returns.rows(), P, 0.0);
+    for (Size t = 0; t < returns.rows(); ++t) {
+        for (Size j = 0; j < returns.columns(); ++j) {
+            double r = returns[t][j];
+            if (!std::isnan(r)) MatrixOperations::axpy(r, weights[j], result[t], P);
+        }
+    }
+    return result;
+}
+
+std::vector<double> RollingAnalytics::weightPathReturns(const Matrix& weightPath, const Matrix& returns) {
+    if (weightPath.rows() != returns.rows() || weightPath.columns() != returns.columns()) {
+        throw std::runtime_error("RollingAnalytics: weight path does not match the return panel");
+    }
+    std::vector<double> result(returns.rows(), 0.0);
+    for (Size t = 0; t < returns.rows(); ++t) {
+        for (Size j = 0; j < returns.columns(); ++j) {
+            double r = returns[t][j];
+            if (!std::isnan(r)) result[t] += weightPath[t][j] * r;
+        }
+    }
+    return result;
+}
+
+// Private helper methods
+void RollingAnalytics::accumulate(const double* row, double benchmark, double sign) {
+    const double target = parameters_.targetReturn;
+    double y = benchmark - benchmarkShift_;
+    benchmarkSum_ += sign * y;
+    benchmarkSquares_ += sign * y * y;
+
+    for (size_t p = 0; p < numPortfolios_; ++p) {
+        double x = row[p] - shift_[p];
+        double d = std::max(target - row[p], 0.0);
+        sum_[p] += sign * x;
+        sumSquares_[p] += sign * x * x;
+        crossProducts_[p] += sign * x * y;
+        downsideSquares_[p] += sign * d * d;
+        downsideCount_[p] += d > 0.0 ? sign : 0.0;
+    }
+}
+
+void RollingAnalytics::clearSums() {
+    for (auto* sums : {&sum_, &sumSquares_, &crossProducts_, &downsideSquares_, &downsideCount_}) {
+        std::fill(sums->begin(), sums->end(), 0.0);
+    }
+    benchmarkSum_ = 0.0;
+    benchmarkSquares_ = 0.0;
+}
+
+void RollingAnalytics::rebuild() {
+    clearSums();
+    for (size_t k = 0; k < window_; ++k) {
+        accumulate(history_.data() + k * numPortfolios_, benchmarkHistory_[k], 1.0);
+    }
+}
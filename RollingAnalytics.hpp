@@ -0,0 +1,97 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <vector>
+
+using namespace QuantLib;
+
+// Rolling volatility, beta, tracking error, Sharpe and Sortino for many
+// portfolios against one benchmark. Each portfolio keeps running sums over
+// the trailing window: returns, squares, the cross product with the
+// benchmark, and downside squares and count. A new row adds its terms and
+// the row leaving the window subtracts them, so a step costs O(1) per
+// portfolio for any window length. Sums are taken about the first row
+// to limit cancellation. They are rebuilt from the window buffer each
+// time it wraps, so add/remove rounding does not build up over long runs.
+//
+// Conventions follow RiskMetrics: sample (n - 1) variances, Sharpe is
+// (mean - rf) / sd, Sortino is (mean - target) / downside deviation over the
+// below-target rows. With annualize set, vol, TE, Sharpe and Sortino scale
+// by sqrt(tradingDaysPerYear); beta does not. Undefined values (window not
+// yet full, zero variance, no downside rows) are NaN, and missing (NaN)
+// returns count as zero.
+class RollingAnalytics {
+public:
+    enum Metric { VOLATILITY, BETA, TRACKING_ERROR, SHARPE, SORTINO, METRIC_COUNT };
+
+    struct RollingParameters {
+        int windowSize{60};
+        double riskFreeRate{0.0};       // daily
+        double targetReturn{0.0};       // Sortino threshold, daily
+        bool annualize{true};
+        int tradingDaysPerYear{252};
+        size_t numThreads{1};           // batch compute; 0 = hardware concurrency
+
+        RollingParameters() = default;
+    };
+
+    // Streaming state for numPortfolios portfolios
+    explicit RollingAnalytics(size_t numPortfolios);
+    RollingAnalytics(size_t numPortfolios, const RollingParameters& parameters);
+
+    // Adds one row (every portfolio's return and the benchmark's) and
+    // retires the row leaving the window
+    void append(const double* portfolioReturns, double benchmarkReturn);
+    void reset();
+
+    bool ready() const { return count_ >= window_; }
+    size_t numPortfolios() const { return numPortfolios_; }
+
+    // Metrics over the current window
+    double metric(size_t portfolio, Metric metric) const;
+    void metrics(size_t portfolio, double* out) const;     // METRIC_COUNT values
+
+    // Every window of a T x P portfolio return panel (rows chronological):
+    // one T x P matrix per Metric, NaN until the first window is full.
+    // Portfolios are split into blocks across a work-stealing pool.
+    static std::vector<Matrix> compute(const Matrix& portfolioReturns,
+                                       const std::vector<double>& benchmarkReturns,
+                                       const RollingParameters& parameters);
+
+    // Single portfolio: T x METRIC_COUNT
+    static Matrix compute(const std::vector<double>& portfolioReturns,
+                          const std::vector<double>& benchmarkReturns,
+                          const RollingParameters& parameters);
+
+    // Portfolio return panels from T x N asset returns, for fixed weights
+    // (N x P, one portfolio per column) or a weight path (T x N, row t held
+    // over return row t)
+    static Matrix portfolioReturns(const Matrix& weights, const Matrix& returns);
+    static std::vector<double> weightPathReturns(const Matrix& weightPath, const Matrix& returns);
+
+private:
+    static const size_t BLOCK = 64;     // portfolios per batch task
+
+    RollingParameters parameters_;
+    size_t numPortfolios_;
+    size_t window_;
+    size_t count_{0};                   // rows appended
+    size_t head_{0};                    // oldest row in the ring buffer
+    double scale_;
+
+    // Trailing window, window_ rows of numPortfolios_ returns
+    std::vector<double> history_;
+    std::vector<double> benchmarkHistory_;
+
+    // Running sums about the shifts, one array per statistic
+    std::vector<double> shift_;
+    std::vector<double> sum_, sumSquares_, crossProducts_;
+    std::vector<double> downsideSquares_, downsideCount_;
+    double benchmarkShift_{0.0};
+    double benchmarkSum_{0.0}, benchmarkSquares_{0.0};
+
+    // Private helper methods
+    void accumulate(const double* row, double benchmark, double sign);
+    void clearSums();
+    void rebuild();
+};
@@ -1,4 +1,6 @@
 #include "StressTesting.hpp"
+#include "MatrixOperations.hpp"
+#include "DrawdownEngine.hpp"
 #include <random>
 #include <cmath>
 #include <stdexcept>
@@ -30,30 +32,92 @@ StressTesting::StressTestResult StressTesting::runStressTest(
     return result;
 }
 
+Matrix StressTesting::generateScenarioMatrix(const std::vector<Scenario>& scenarios) {
+    Size rows = historicalReturns_.rows();
+    Size columns = historicalReturns_.columns();
+    
+    // Reject a bad scenario before paying for any of the others
+    for (const auto& scenario : scenarios) {
+        validateScenario(scenario, columns);
+    }
+    Matrix stacked(rows * scenarios.size(), columns);
+    
+    for (Size k = 0; k < scenarios.size(); ++k) {
+        Matrix stressedReturns = generateStressedReturns(historicalReturns_, scenarios[k]);
+        std::copy(stressedReturns.begin(), stressedReturns.end(), stacked[k * rows]);
+    }
+    
+    return stacked;
+}
+
 Matrix StressTesting::generateStressedReturns(
     const Matrix& historicalReturns, const Scenario& scenario) {
     
+    validateScenario(scenario, historicalReturns.columns());
     Matrix stressedReturns = historicalReturns;
-    
-    // Apply market shocks
-    for (Size i = 0; i < historicalReturns.rows(); ++i) {
-        for (Size j = 0; j < historicalReturns.columns(); ++j) {
-            stressedReturns[i][j] *= (1.0 + scenario.marketShocks[j]);
+    Size rows = historicalReturns.rows();
+    Size n = historicalReturns.columns();
+    
+    // Volatility and correlation shocks re-mix the standardized returns:
+    // z = U_new' U_old'^-1 (r - mean) / sd, with C = U'U, then rescale by the
+    // shocked volatility. Skipped (O(T N^2)) when neither is given.
+    bool shockVolatility = !scenario.volatilityShocks.empty();
+    bool shockCorrelation = !scenario.correlationShocks.empty();
+    if ((shockVolatility || shockCorrelation) && rows > 1) {
+        Matrix volatility = calculateVolatility(historicalReturns);
+        std::vector<double> mean(n, 0.0);
+        for (Size t = 0; t < rows; ++t) {
+            MatrixOperations::axpy(1.0 / rows, historicalReturns[t], mean.data(), n);
+        }
+        
+        PackedCholesky original, shocked;
+        if (shockCorrelation) {
+            SymmetricMatrix correlation = calculateCorrelation(historicalReturns);
+            SymmetricMatrix stressedCorrelation = correlation;
+            for (Size i = 0; i < n; ++i) {
+                Real* row = stressedCorrelation.row(i);
+                for (Size j = i + 1; j < n; ++j) {
+                    row[j - i] *= (1.0 + scenario.correlationShocks[i * n + j]);
+                }
+            }
+            try {
+                original = PackedCholesky(correlation);
+                shocked = PackedCholesky(stressedCorrelation);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("scenario " + scenario.name +
+                                         ": correlation not positive definite: " + std::string(e.what()));
+            }
+        }
+        
+        std::vector<double> z(n), mixed(n);
+        for (Size t = 0; t < rows; ++t) {
+            Real* row = stressedReturns[t];
+            for (Size j = 0; j < n; ++j) {
+                double sd = volatility[j][0];
+                z[j] = sd > 0.0 ? (row[j] - mean[j]) / sd : 0.0;
+            }
+            if (shockCorrelation) {
+                original.solveLower(z.data());
+                std::fill(mixed.begin(), mixed.end(), 0.0);
+                for (Size i = 0; i < n; ++i) {
+                    const Real* factorRow = shocked.factor().row(i);
+                    MatrixOperations::axpy(z[i], factorRow, mixed.data() + i, n - i);
+                }
+                z.swap(mixed);
+            }
+            for (Size j = 0; j < n; ++j) {
+                double sd = volatility[j][0];
+                if (shockVolatility) sd *= (1.0 + scenario.volatilityShocks[j]);
+                row[j] = mean[j] + sd * z[j];
+            }
         }
     }
     
-    // Apply volatility shocks
-    Matrix volatility = calculateVolatility(historicalReturns);
-    for (Size i = 0; i < volatility.rows(); ++i) {
-        volatility[i][0] *= (1.0 + scenario.volatilityShocks[i]);
-    }
-    
-    // Apply correlation shocks
-    Matrix correlation = calculateCorrelation(historicalReturns);
-    for (Size i = 0; i < correlation.rows(); ++i) {
-        for (Size j = 0; j < correlation.columns(); ++j) {
-            if (i != j) {
-                correlation[i][j] *= (1.0 + scenario.correlationShocks[i * correlation.columns() + j]);
+    // Apply market shocks
+    if (!scenario.marketShocks.empty()) {
+        for (Size i = 0; i < rows; ++i) {
+            for (Size j = 0; j < n; ++j) {
+                stressedReturns[i][j] *= (1.0 + scenario.marketShocks[j]);
             }
         }
     }
@@ -61,6 +125,20 @@ Matrix StressTesting::generateStressedReturns(
     return stressedReturns;
 }
 
+void StressTesting::validateScenario(const Scenario& scenario, Size numAssets) const {
+    // Empty shock vectors leave that dimension unstressed
+    auto check = [&](const std::vector<double>& shocks, Size expected, const char* label) {
+        if (!shocks.empty() && shocks.size() != expected) {
+            throw std::runtime_error("scenario " + scenario.name + ": " + label + " has " +
+                                     std::to_string(shocks.size()) + " entries, expected " +
+                                     std::to_string(expected));
+        }
+    };
+    check(scenario.marketShocks, numAssets, "marketShocks");
+    check(scenario.volatilityShocks, numAssets, "volatilityShocks");
+    check(scenario.correlationShocks, numAssets * numAssets, "correlationShocks");
+}
+
 std::vector<double> StressTesting::calculateFactorContributions(
     const Matrix& weights, const Matrix& stressedReturns) {
     
@@ -87,17 +165,8 @@ double StressTesting::calculateStressedReturn(const Matrix& stressedReturns) {
 }
 
 double StressTesting::calculateMaxDrawdown(const Matrix& stressedReturns) {
-    double maxDrawdown = 0.0;
-    double peak = 1.0;
-    double value = 1.0;
-    
-    for (Size i = 0; i < stressedReturns.rows(); ++i) {
-        value *= (1.0 + stressedReturns[i][0]);
-        peak = std::max(peak, value);
-        maxDrawdown = std::max(maxDrawdown, (peak - value) / peak);
-    }
-    
-    return maxDrawdown;
+    // Single-column portfolio return series
+    return DrawdownEngine::analyze(stressedReturns)[0].maxDrawdown;
 }
 
 std::tuple<double, double> StressTesting::calculateStressedRiskMetrics(
@@ -125,13 +194,31 @@ std::tuple<double, double> StressTesting::calculateStressedRiskMetrics(
 }
 
 Matrix StressTesting::calculateVolatility(const Matrix& returns) {
-    // Implementation of volatility calculation
-    return Matrix();
+    // Sample (T - 1) standard deviation per column, N x 1
+    Size rows = returns.rows();
+    Size n = returns.columns();
+    Matrix volatility(n, 1, 0.0);
+    if (rows < 2) return volatility;
+    
+    std::vector<double> mean(n, 0.0);
+    for (Size t = 0; t < rows; ++t) {
+        MatrixOperations::axpy(1.0 / rows, returns[t], mean.data(), n);
+    }
+    for (Size t = 0; t < rows; ++t) {
+        for (Size j = 0; j < n; ++j) {
+            double d = returns[t][j] - mean[j];
+            volatility[j][0] += d * d;
+        }
+    }
+    for (Size j = 0; j < n; ++j) {
+        volatility[j][0] = std::sqrt(volatility[j][0] / (rows - 1));
+    }
+    return volatility;
 }
 
-Matrix StressTesting::calculateCorrelation(const Matrix& returns) {
-    // Implementation of correlation calculation
-    return Matrix();
+SymmetricMatrix StressTesting::calculateCorrelation(const Matrix& returns) {
+    return MatrixOperations::correlationFromCovariance(
+        MatrixOperations::sampleCovariance(returns));
 }
 
 Matrix StressTesting::decomposeFatorReturns(const Matrix& returns) {
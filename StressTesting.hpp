@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include "SymmetricMatrix.hpp"
 
 using namespace QuantLib;
 
@@ -31,13 +32,21 @@ public:
     StressTestResult runStressTest(const Matrix& weights,
                                  const Scenario& scenario);
 
+    // Stressed return panels of the scenarios stacked row-wise, as a
+    // scenario matrix for CVaROptimizer; every scenario is validated first
+    Matrix generateScenarioMatrix(const std::vector<Scenario>& scenarios);
+
 private:
     // Member variables
     Matrix historicalReturns_;
 
     // Helper methods
+    // Empty shock vectors are skipped; otherwise marketShocks and
+    // volatilityShocks need N entries and correlationShocks N x N (row-major,
+    // upper triangle used)
     Matrix generateStressedReturns(const Matrix& historicalReturns,
                                  const Scenario& scenario);
+    void validateScenario(const Scenario& scenario, Size numAssets) const;
     
     double calculateStressedReturn(const Matrix& stressedReturns);
     double calculateMaxDrawdown(const Matrix& stressedReturns);
@@ -47,6 +56,6 @@ private:
     
     // Additional helper methods
     Matrix calculateVolatility(const Matrix& returns);
-    Matrix calculateCorrelation(const Matrix& returns);
+    SymmetricMatrix calculateCorrelation(const Matrix& returns);
     Matrix decomposeFatorReturns(const Matrix& returns);
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "SymmetricMatrix.hpp"
+#include "MatrixOperations.hpp"
+#include <cmath>
+
+SymmetricMatrix::SymmetricMatrix(const Matrix& dense)
+    : size_(dense.rows()), data_(dense.rows() * (dense.rows() + 1) / 2) {
+
+    if (dense.rows() != dense.columns()) {
+        throw std::runtime_error("SymmetricMatrix: source matrix must be square");
+    }
+    for (Size i = 0; i < size_; ++i) {
+        std::copy(dense[i] + i, dense[i] + size_, row(i));
+    }
+}
+
+Matrix SymmetricMatrix::toMatrix() const {
+    Matrix dense(size_, size_);
+    for (Size i = 0; i < size_; ++i) {
+        const Real* upper = row(i);
+        for (Size j = i; j < size_; ++j) {
+            dense[i][j] = upper[j - i];
+            dense[j][i] = upper[j - i];
+        }
+    }
+    return dense;
+}
+
+PackedCholesky::PackedCholesky(const SymmetricMatrix& matrix) {
+    factorize(matrix);
+}
+
+void PackedCholesky::factorize(const SymmetricMatrix& matrix) {
+    factor_ = matrix;
+
+    Size n = factor_.size();
+    for (Size i = 0; i < n; ++i) {
+        Real* rowI = factor_.row(i);
+        if (!(rowI[0] > 0.0)) {
+            throw std::runtime_error("PackedCholesky: matrix is not positive definite");
+        }
+
+        double pivot = std::sqrt(rowI[0]);
+        rowI[0] = pivot;
+        for (Size k = 1; k < n - i; ++k) {
+            rowI[k] /= pivot;
+        }
+
+        // Trailing update A_jk -= U_ij U_ik for i < j <= k
+        for (Size j = i + 1; j < n; ++j) {
+            MatrixOperations::axpy(-rowI[j - i], rowI + (j - i), factor_.row(j), n - j);
+        }
+    }
+}
+
+void PackedCholesky::solve(const Real* b, Real* x) const {
+    if (x != b) {
+        std::copy(b, b + size(), x);
+    }
+    solveLower(x);
+    solveUpper(x);
+}
+
+Matrix PackedCholesky::solve(const Matrix& b) const {
+    Size n = size();
+    if (b.rows() != n) {
+        throw std::runtime_error("PackedCholesky: right-hand side size mismatch");
+    }
+
+    Matrix x(n, b.columns());
+    std::vector<Real> column(n);
+    for (Size c = 0; c < b.columns(); ++c) {
+        for (Size i = 0; i < n; ++i) {
+            column[i] = b[i][c];
+        }
+        solveLower(column.data());
+        solveUpper(column.data());
+        for (Size i = 0; i < n; ++i) {
+            x[i][c] = column[i];
+        }
+    }
+    return x;
+}
+
+void PackedCholesky::solveLower(Real* x) const {
+    // Column-oriented forward substitution with U' keeps row access contiguous
+    Size n = size();
+    for (Size i = 0; i < n; ++i) {
+        const Real* rowI = factor_.row(i);
+        x[i] /= rowI[0];
+        MatrixOperations::axpy(-x[i], rowI + 1, x + i + 1, n - i - 1);
+    }
+}
+
+void PackedCholesky::solveUpper(Real* x) const {
+    Size n = size();
+    for (Size i = n; i-- > 0;) {
+        const Real* rowI = factor_.row(i);
+        x[i] = (x[i] - MatrixOperations::dot(rowI + 1, x + i + 1, n - i - 1)) / rowI[0];
+    }
+}
+
+double PackedCholesky::logDeterminant() const {
+    double logDet = 0.0;
+    for (Size i = 0; i < size(); ++i) {
+        logDet += 2.0 * std::log(factor_.row(i)[0]);
+    }
+    return logDet;
+}
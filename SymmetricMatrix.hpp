@@ -0,0 +1,77 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <vector>
+#include <stdexcept>
+
+using namespace QuantLib;
+
+// Symmetric N x N matrix in packed upper-triangular storage: row i holds
+// entries (i, i..N-1) contiguously, so N(N+1)/2 values are kept instead of
+// N^2. Used for covariance and correlation estimates; the kernels in
+// MatrixOperations.hpp operate on it directly.
+class SymmetricMatrix {
+public:
+    SymmetricMatrix() : size_(0) {}
+    explicit SymmetricMatrix(Size n, Real value = 0.0)
+        : size_(n), data_(n * (n + 1) / 2, value) {}
+
+    // Packs the upper triangle of a dense symmetric matrix
+    explicit SymmetricMatrix(const Matrix& dense);
+
+    Size size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    Size packedSize() const { return data_.size(); }
+    Size memoryBytes() const { return data_.size() * sizeof(Real); }
+
+    // Upper row i starts at the diagonal: row(i)[k] is entry (i, i + k)
+    Real* row(Size i) { return data_.data() + offset(i); }
+    const Real* row(Size i) const { return data_.data() + offset(i); }
+
+    Real operator()(Size i, Size j) const {
+        return i <= j ? data_[offset(i) + (j - i)] : data_[offset(j) + (i - j)];
+    }
+    Real& operator()(Size i, Size j) {
+        return i <= j ? data_[offset(i) + (j - i)] : data_[offset(j) + (i - j)];
+    }
+
+    Real* begin() { return data_.data(); }
+    const Real* begin() const { return data_.data(); }
+    Real* end() { return data_.data() + data_.size(); }
+    const Real* end() const { return data_.data() + data_.size(); }
+
+    Matrix toMatrix() const;
+
+private:
+    Size size_;
+    std::vector<Real> data_;
+
+    Size offset(Size i) const { return i * size_ - i * (i - 1) / 2; }
+};
+
+// Cholesky factor S = U'U of a packed symmetric positive definite matrix,
+// with U stored in the same packed upper layout. Factorization is
+// right-looking so every update is a contiguous axpy over a packed row.
+class PackedCholesky {
+public:
+    PackedCholesky() = default;
+    explicit PackedCholesky(const SymmetricMatrix& matrix);
+
+    // Refactors in place, reusing the storage of a same-size factor
+    void factorize(const SymmetricMatrix& matrix);
+
+    Size size() const { return factor_.size(); }
+    const SymmetricMatrix& factor() const { return factor_; }
+
+    // Solves S x = b; x and b may alias
+    void solve(const Real* b, Real* x) const;
+    Matrix solve(const Matrix& b) const;
+
+    // Solves U'y = b (forward substitution) and U x = y (back substitution)
+    void solveLower(Real* x) const;
+    void solveUpper(Real* x) const;
+
+    double logDeterminant() const;
+
+private:
+    SymmetricMatrix factor_;
+};
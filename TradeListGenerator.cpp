@@ -0,0 +1,219 @@
+#include "TradeListGenerator.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+
+TradeListGenerator::TradeListGenerator()
+    : TradeListGenerator(TradeListParameters()) {}
+
+TradeListGenerator::TradeListGenerator(const TradeListParameters& parameters)
+    : parameters_(parameters)
+    , pool_(std::make_unique<WorkStealingPool>(parameters.numThreads)) {
+
+    if (!(parameters.lotSize > 0.0)) {
+        throw std::runtime_error("TradeListGenerator: lot size must be positive");
+    }
+    if (parameters.minTradeSize < 0.0 || parameters.maxTradeSize < parameters.minTradeSize) {
+        throw std::runtime_error("TradeListGenerator: trade size limits must satisfy 0 <= min <= max");
+    }
+}
+
+TradeListGenerator::TradeListParameters TradeListGenerator::fromLimits(
+    const RiskConstraints::ConstraintLimits& limits) {
+
+    TradeListParameters parameters;
+    parameters.minTradeSize = limits.minTradeSize;
+    parameters.maxTradeSize = limits.maxTradeSize;
+    return parameters;
+}
+
+TradeListGenerator::TradeList TradeListGenerator::generate(
+    const std::vector<double>& currentWeights,
+    const std::vector<double>& targetWeights,
+    const std::vector<double>& prices,
+    double portfolioValue) const {
+
+    try {
+        const Size n = prices.size();
+        if (currentWeights.size() != n || targetWeights.size() != n) {
+            throw std::runtime_error("weights do not match prices");
+        }
+        if (!lotSizes_.empty() && lotSizes_.size() != n) {
+            throw std::runtime_error("lot sizes do not match prices");
+        }
+        if (!(portfolioValue > 0.0)) {
+            throw std::runtime_error("portfolio value must be positive");
+        }
+
+        const double minNotional = parameters_.minTradeSize * portfolioValue;
+        const double maxNotional = parameters_.maxTradeSize * portfolioValue;
+
+        TradeList result;
+        std::vector<Line> lines(n);
+        std::vector<double> ideal(n, 0.0);
+        double surplus = 0.0;
+
+        for (Size i = 0; i < n; ++i) {
+            Line& line = lines[i];
+            ideal[i] = (targetWeights[i] - currentWeights[i]) * portfolioValue;
+            surplus += ideal[i];
+
+            double trade = ideal[i];
+            if (trade == 0.0) continue;
+            if (std::abs(trade) < minNotional) {
+                ++result.dropped;
+                continue;
+            }
+            if (!(prices[i] > 0.0)) {
+                throw std::runtime_error("asset " + std::to_string(i) + " trades without a valid price");
+            }
+
+            double size = lotSize(i);
+            double heldShares = currentWeights[i] * portfolioValue / prices[i];
+            line.lotValue = size * prices[i];
+
+            if (std::abs(trade) > maxNotional) {
+                trade = std::copysign(maxNotional, trade);
+                line.capped = true;
+            }
+            else if (targetWeights[i] == 0.0 && heldShares > 0.0 && parameters_.liquidateOddLots) {
+                // Sell everything, odd lot included; the repair leaves it alone
+                line.exit = true;
+                line.lots = -heldShares / size;
+                line.ideal = line.lots;
+                continue;
+            }
+
+            line.ideal = trade / line.lotValue;
+            line.upper = std::floor(maxNotional / line.lotValue + 1e-9);
+            if (line.upper == 0.0) {
+                // A single lot is worth more than maxTradeSize
+                ++result.untradable;
+                continue;
+            }
+            line.lower = -line.upper;
+            if (targetWeights[i] >= 0.0 && heldShares >= 0.0) {
+                line.lower = std::max(line.lower, -std::floor(heldShares / size + 1e-9));
+            }
+            line.minLots = std::max(1.0, std::ceil(minNotional / line.lotValue - 1e-9));
+
+            // Nearest lot count, then the closer of zero and the minimum size
+            double lots = std::min(std::max(std::round(line.ideal), line.lower), line.upper);
+            if (lots != 0.0 && std::abs(lots) < line.minLots) {
+                double minimum = std::copysign(line.minLots, lots);
+                bool fits = minimum >= line.lower && minimum <= line.upper;
+                lots = fits && std::abs(line.ideal - minimum) < std::abs(line.ideal) ? minimum : 0.0;
+            }
+            line.lots = lots;
+        }
+
+        for (const Line& line : lines) {
+            surplus -= line.lots * line.lotValue;
+        }
+        repair(lines, surplus, portfolioValue);
+
+        double squaredError = 0.0;
+        for (Size i = 0; i < n; ++i) {
+            const Line& line = lines[i];
+            double notional = line.lots * line.lotValue;
+            squaredError += (ideal[i] - notional) * (ideal[i] - notional);
+            if (line.lots == 0.0) continue;
+
+            Order order;
+            order.asset = i;
+            order.shares = line.lots * lotSize(i);
+            order.price = prices[i];
+            order.notional = notional;
+            order.capped = line.capped;
+            result.orders.push_back(order);
+        }
+        result.cashResidual = surplus;
+        result.trackingError = std::sqrt(squaredError) / portfolioValue;
+        return result;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error in TradeListGenerator::generate: " + std::string(e.what()));
+    }
+}
+
+std::vector<TradeListGenerator::TradeList> TradeListGenerator::generate(
+    const std::vector<Account>& accounts,
+    const std::vector<double>& prices) {
+
+    PROFILE_SCOPE("trade_list_batch");
+    std::vector<TradeList> results(accounts.size());
+    pool_->parallelFor(accounts.size(), [&](size_t index, size_t) {
+        const Account& account = accounts[index];
+        results[index] = generate(account.currentWeights, account.targetWeights,
+                                  prices, account.portfolioValue);
+    });
+    return results;
+}
+
+// Private helper methods
+double TradeListGenerator::lotSize(Size asset) const {
+    return lotSizes_.empty() ? parameters_.lotSize : lotSizes_[asset];
+}
+
+void TradeListGenerator::repair(std::vector<Line>& lines, double& surplus, double portfolioValue) const {
+    // Squared weight error of one line at a lot count
+    auto error = [portfolioValue](const Line& line, double lots) {
+        double gap = (line.ideal - lots) * line.lotValue / portfolioValue;
+        return gap * gap;
+    };
+
+    // (score, asset, lots after the move); the best score pops first
+    using Candidate = std::tuple<double, Size, double>;
+    auto worse = [](const Candidate& a, const Candidate& b) {
+        if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+        return std::get<1>(a) > std::get<1>(b);
+    };
+
+    for (int direction : {-1, 1}) {
+        // -1 sheds lots while overspent, +1 spends a surplus
+        if (direction < 0 ? surplus >= 0.0 : surplus <= 0.0) continue;
+
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)> heap(worse);
+        auto push = [&](Size i) {
+            const Line& line = lines[i];
+            double lots;
+            if (!nextLots(line, direction, lots)) return;
+            double cash = std::abs(lots - line.lots) * line.lotValue;
+            double gain = error(line, line.lots) - error(line, lots);
+            if (direction > 0 && gain <= 0.0) return;
+            heap.emplace(gain / cash, i, lots);
+        };
+        for (Size i = 0; i < lines.size(); ++i) {
+            push(i);
+        }
+
+        while (!heap.empty() && (direction < 0 ? surplus < 0.0 : surplus > 0.0)) {
+            Size i = std::get<1>(heap.top());
+            double lots = std::get<2>(heap.top());
+            heap.pop();
+
+            Line& line = lines[i];
+            double cash = (lots - line.lots) * line.lotValue;
+            // A surplus only shrinks, so a lot that does not fit now never will
+            if (direction > 0 && cash > surplus) continue;
+
+            surplus -= cash;
+            line.lots = lots;
+            push(i);
+        }
+    }
+}
+
+bool TradeListGenerator::nextLots(const Line& line, int direction, double& lots) const {
+    if (line.exit || line.lotValue <= 0.0) return false;
+
+    // One lot further, jumping across the gap between zero and minLots
+    lots = line.lots + direction;
+    if (lots != 0.0 && std::abs(lots) < line.minLots) {
+        lots = std::abs(line.lots) < line.minLots ? std::copysign(line.minLots, lots) : 0.0;
+    }
+    return lots >= line.lower && lots <= line.upper;
+}
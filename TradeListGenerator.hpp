@@ -0,0 +1,103 @@
+#pragma once
+#include <ql/quantlib.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "RiskConstraints.hpp"
+#include "WorkStealingPool.hpp"
+
+using namespace QuantLib;
+
+// Turns target weights into executable orders: whole round lots, each
+// order's notional inside [minTradeSize, maxTradeSize] of portfolio value,
+// and a sparse list holding only the assets that trade.
+//
+// Each asset's ideal trade is clipped to maxTradeSize and rounded to the
+// nearest lot. Trades below minTradeSize are dropped, and assets whose single
+// lot exceeds maxTradeSize are reported as untradable. A full exit (target
+// weight 0) sells the whole position, odd lot included. Rounding leaves a
+// cash residual against the ideal net trade, which a greedy knapsack pass
+// repairs:
+//  - surplus cash buys the lots with the best reduction in squared weight
+//    error per unit of cash, while they still fit in the surplus;
+//  - overspending sheds the lots that cost the least error per unit of cash
+//    freed, until the list no longer spends more than the ideal one.
+// Candidate lots sit in a heap keyed on that ratio, so the repair costs
+// O((N + lots moved) log N). Accounts in a batch share prices and lot sizes
+// and run on a work-stealing pool.
+class TradeListGenerator {
+public:
+    struct TradeListParameters {
+        double lotSize{100.0};          // shares per round lot, unless set per asset
+        double minTradeSize{0.001};     // fraction of portfolio value
+        double maxTradeSize{0.05};      // fraction of portfolio value, per order
+        bool liquidateOddLots{true};    // full exits trade the odd-lot remainder
+        size_t numThreads{0};           // batch; 0 = hardware concurrency
+
+        TradeListParameters() = default;
+    };
+
+    // One order; shares > 0 buys, < 0 sells
+    struct Order {
+        Size asset{0};
+        double shares{0.0};
+        double price{0.0};
+        double notional{0.0};           // shares * price, signed
+        bool capped{false};             // ideal trade exceeded maxTradeSize
+    };
+
+    struct TradeList {
+        std::vector<Order> orders;      // ascending asset
+        double cashResidual{0.0};       // ideal net buys less actual; >= 0 unless unrepairable
+        double trackingError{0.0};      // L2 distance to the ideal trade, in weight
+        size_t dropped{0};              // ideal trades below minTradeSize
+        size_t untradable{0};           // ideal trades where one lot exceeds maxTradeSize
+    };
+
+    // Current and target holdings of one account
+    struct Account {
+        std::vector<double> currentWeights;
+        std::vector<double> targetWeights;
+        double portfolioValue{0.0};
+    };
+
+    TradeListGenerator();
+    explicit TradeListGenerator(const TradeListParameters& parameters);
+
+    // Minimum and maximum trade sizes from RiskConstraints
+    static TradeListParameters fromLimits(const RiskConstraints::ConstraintLimits& limits);
+
+    // Per-asset lot sizes; empty = parameters' lotSize everywhere
+    void setLotSizes(const std::vector<double>& lotSizes) { lotSizes_ = lotSizes; }
+
+    TradeList generate(const std::vector<double>& currentWeights,
+                       const std::vector<double>& targetWeights,
+                       const std::vector<double>& prices,
+                       double portfolioValue) const;
+
+    // Many accounts against one price vector
+    std::vector<TradeList> generate(const std::vector<Account>& accounts,
+                                    const std::vector<double>& prices);
+
+private:
+    // Per-asset state of one account's rounding
+    struct Line {
+        double ideal{0.0};              // ideal trade in lots
+        double lots{0.0};               // current integer trade in lots
+        double lotValue{0.0};           // currency per lot
+        double lower{0.0};              // lots bounds: maxTradeSize, no new shorts
+        double upper{0.0};
+        double minLots{1.0};            // smallest non-zero |lots|
+        bool exit{false};               // full exit, fixed at the held shares
+        bool capped{false};
+    };
+
+    TradeListParameters parameters_;
+    std::vector<double> lotSizes_;
+    std::unique_ptr<WorkStealingPool> pool_;
+
+    // Private helper methods
+    double lotSize(Size asset) const;
+    void repair(std::vector<Line>& lines, double& surplus, double portfolioValue) const;
+    bool nextLots(const Line& line, int direction, double& lots) const;
+};
@@ -0,0 +1,150 @@
+#include "TradingCalendar.hpp"
+#include "ParallelCSVLoader.hpp"
+#include <algorithm>
+
+TradingCalendar::TradingCalendar(const std::vector<boost::gregorian::date>& dates) {
+    newestFirst_ = dates.size() > 1 && dates.front() > dates.back();
+    days_.reserve(dates.size());
+    if (newestFirst_) {
+        for (auto it = dates.rbegin(); it != dates.rend(); ++it) append(*it);
+    } else {
+        for (const auto& date : dates) append(date);
+    }
+}
+
+TradingCalendar::TradingCalendar(const std::vector<std::string>& dates) {
+    std::vector<boost::gregorian::date> parsed;
+    parsed.reserve(dates.size());
+    for (const auto& date : dates) {
+        parsed.push_back(ParallelCSVLoader::parseDate(date.data(), date.data() + date.size()));
+    }
+    *this = TradingCalendar(parsed);
+}
+
+int32_t TradingCalendar::dayNumber(const std::string& date) {
+    return dayNumber(ParallelCSVLoader::parseDate(date.data(), date.data() + date.size()));
+}
+
+void TradingCalendar::append(const boost::gregorian::date& date) {
+    int32_t day = dayNumber(date);
+    if (!days_.empty() && day <= days_.back()) {
+        throw std::runtime_error("TradingCalendar: dates must be strictly increasing, got " +
+            boost::gregorian::to_simple_string(date));
+    }
+
+    // New boundary whenever the month changes; quarters and years follow from it
+    auto ymd = date.year_month_day();
+    int year = ymd.year;
+    int month = ymd.month;
+    uint32_t position = static_cast<uint32_t>(days_.size());
+    if (days_.empty() || year != lastYear_ || month != lastMonth_) {
+        monthStarts_.push_back(position);
+        if (days_.empty() || year != lastYear_ || (month - 1) / 3 != (lastMonth_ - 1) / 3) {
+            quarterStarts_.push_back(position);
+        }
+        if (days_.empty() || year != lastYear_) {
+            yearStarts_.push_back(position);
+        }
+        lastYear_ = year;
+        lastMonth_ = month;
+    }
+    days_.push_back(day);
+}
+
+void TradingCalendar::append(const std::string& date) {
+    append(ParallelCSVLoader::parseDate(date.data(), date.data() + date.size()));
+}
+
+boost::gregorian::date TradingCalendar::date(size_t row) const {
+    static const boost::gregorian::date epoch(1970, 1, 1);
+    return epoch + boost::gregorian::date_duration(day(row) - dayNumber(epoch));
+}
+
+size_t TradingCalendar::find(const boost::gregorian::date& date) const {
+    return find(dayNumber(date));
+}
+
+size_t TradingCalendar::find(int32_t day) const {
+    auto it = std::lower_bound(days_.begin(), days_.end(), day);
+    if (it == days_.end() || *it != day) {
+        return npos;
+    }
+    return toRow(static_cast<size_t>(it - days_.begin()));
+}
+
+TradingCalendar::RowRange TradingCalendar::rows(const boost::gregorian::date& from,
+                                                const boost::gregorian::date& to) const {
+    auto begin = std::lower_bound(days_.begin(), days_.end(), dayNumber(from));
+    auto end = std::upper_bound(begin, days_.end(), dayNumber(to));
+    return toRows(static_cast<size_t>(begin - days_.begin()),
+                  static_cast<size_t>(end - days_.begin()));
+}
+
+TradingCalendar::RowRange TradingCalendar::trailing(size_t row, size_t count) const {
+    if (row >= days_.size()) {
+        throw std::runtime_error("TradingCalendar: row out of range");
+    }
+    size_t end = toIndex(row) + 1;
+    return toRows(end - std::min(count, end), end);
+}
+
+TradingCalendar::RowRange TradingCalendar::period(Period period, size_t k) const {
+    const std::vector<uint32_t>& starts = boundaries(period);
+    if (k >= starts.size()) {
+        throw std::runtime_error("TradingCalendar: period out of range");
+    }
+    size_t end = k + 1 < starts.size() ? starts[k + 1] : days_.size();
+    return toRows(starts[k], end);
+}
+
+size_t TradingCalendar::periodOf(Period period, size_t row) const {
+    const std::vector<uint32_t>& starts = boundaries(period);
+    auto it = std::upper_bound(starts.begin(), starts.end(), static_cast<uint32_t>(toIndex(row)));
+    return static_cast<size_t>(it - starts.begin()) - 1;
+}
+
+size_t TradingCalendar::firstRow(Period period, size_t k) const {
+    return toRow(boundaries(period).at(k));
+}
+
+size_t TradingCalendar::lastRow(Period period, size_t k) const {
+    const std::vector<uint32_t>& starts = boundaries(period);
+    size_t end = k + 1 < starts.size() ? starts[k + 1] : days_.size();
+    return toRow(end - 1);
+}
+
+bool TradingCalendar::isPeriodEnd(Period period, size_t row) const {
+    size_t next = toIndex(row) + 1;
+    if (next == days_.size()) return true;
+    const std::vector<uint32_t>& starts = boundaries(period);
+    return std::binary_search(starts.begin(), starts.end(), static_cast<uint32_t>(next));
+}
+
+std::vector<int32_t> TradingCalendar::periodEndDays(Period period) const {
+    const std::vector<uint32_t>& starts = boundaries(period);
+    std::vector<int32_t> ends;
+    ends.reserve(starts.size());
+    for (size_t k = 1; k < starts.size(); ++k) {
+        ends.push_back(days_[starts[k] - 1]);
+    }
+    if (!days_.empty()) {
+        ends.push_back(days_.back());
+    }
+    return ends;
+}
+
+// Private helper methods
+TradingCalendar::RowRange TradingCalendar::toRows(size_t begin, size_t end) const {
+    if (!newestFirst_) {
+        return RowRange{begin, end};
+    }
+    return RowRange{days_.size() - end, days_.size() - begin};
+}
+
+const std::vector<uint32_t>& TradingCalendar::boundaries(Period period) const {
+    switch (period) {
+        case Period::Month: return monthStarts_;
+        case Period::Quarter: return quarterStarts_;
+        default: return yearStarts_;
+    }
+}
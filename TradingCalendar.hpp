@@ -0,0 +1,90 @@
+#pragma once
+#include <boost/date_time.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Compact index over the trading dates of a return panel. Dates are held as
+// int32 day numbers in chronological order with precomputed month, quarter
+// and year boundary tables, so date ranges, rolling windows, rebalance
+// schedules and report periods resolve to row ranges by binary search.
+//
+// Rows are numbered as in the panel the calendar was built from; both
+// oldest-first (DataManager, weight.cpp) and newest-first panels are
+// supported. append() always adds a date later than all existing ones,
+// i.e. the next row of an oldest-first panel or the new row 0 of a
+// newest-first one.
+class TradingCalendar {
+public:
+    enum class Period { Month, Quarter, Year };
+
+    // Half-open row range [first, last)
+    struct RowRange {
+        size_t first{0};
+        size_t last{0};
+
+        size_t size() const { return last - first; }
+        bool empty() const { return last == first; }
+        bool contains(size_t row) const { return row >= first && row < last; }
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    TradingCalendar() = default;
+    explicit TradingCalendar(const std::vector<boost::gregorian::date>& dates);
+    explicit TradingCalendar(const std::vector<std::string>& dates);
+
+    void append(const boost::gregorian::date& date);
+    void append(const std::string& date);
+
+    static int32_t dayNumber(const boost::gregorian::date& date) {
+        return static_cast<int32_t>(date.day_number());
+    }
+    static int32_t dayNumber(const std::string& date);
+
+    size_t size() const { return days_.size(); }
+    bool empty() const { return days_.empty(); }
+    bool newestFirst() const { return newestFirst_; }
+    int32_t day(size_t row) const { return days_[toIndex(row)]; }
+    boost::gregorian::date date(size_t row) const;
+
+    // Row of an exact date, or npos
+    size_t find(const boost::gregorian::date& date) const;
+    size_t find(int32_t day) const;
+
+    // Rows dated within [from, to], inclusive
+    RowRange rows(const boost::gregorian::date& from, const boost::gregorian::date& to) const;
+
+    // `count` consecutive trading days ending at (and including) `row`
+    RowRange trailing(size_t row, size_t count) const;
+
+    // Periods are numbered chronologically from 0
+    size_t periodCount(Period period) const { return boundaries(period).size(); }
+    RowRange period(Period period, size_t k) const;
+    size_t periodOf(Period period, size_t row) const;
+    size_t firstRow(Period period, size_t k) const;
+    size_t lastRow(Period period, size_t k) const;
+    bool isPeriodEnd(Period period, size_t row) const;
+
+    // Last trading day of every period, chronologically
+    std::vector<int32_t> periodEndDays(Period period) const;
+
+private:
+    bool newestFirst_{false};
+    std::vector<int32_t> days_;     // chronological
+
+    // Chronological index of the first day of each period
+    std::vector<uint32_t> monthStarts_;
+    std::vector<uint32_t> quarterStarts_;
+    std::vector<uint32_t> yearStarts_;
+
+    // Last (year, month) seen, to extend the boundary tables on append
+    int lastYear_{0};
+    int lastMonth_{0};
+
+    size_t toIndex(size_t row) const { return newestFirst_ ? days_.size() - 1 - row : row; }
+    size_t toRow(size_t index) const { return newestFirst_ ? days_.size() - 1 - index : index; }
+    RowRange toRows(size_t begin, size_t end) const;
+    const std::vector<uint32_t>& boundaries(Period period) const;
+};
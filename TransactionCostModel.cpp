@@ -1,4 +1,5 @@
 #include "TransactionCostModel.hpp"
+#include "Profiler.hpp"
 #include <cmath>
 
 double TransactionCostModel::calculateTotalCost(
@@ -7,32 +8,36 @@ double TransactionCostModel::calculateTotalCost(
     const Matrix& prices,
     double portfolioValue) {
     
+    PROFILE_SCOPE("transaction_cost");
     double totalCost = 0.0;
     int numAssets = currentWeights.rows();
 
     for (int i = 0; i < numAssets; ++i) {
         double tradeSize = std::abs(targetWeights[i][0] - currentWeights[i][0]) * portfolioValue;
-        
-        if (tradeSize > 0) {
-            // Fixed commission per trade
-            totalCost += costs_.fixedCommission;
-            
-            // Variable commission
-            totalCost += tradeSize * costs_.variableCommission;
-            
-            // Market impact with decay
-            double marketImpact = calculateMarketImpactDecay(
-                tradeSize, avgVolumes_[i], daysToExecute_);
-            totalCost += marketImpact;
-            
-            // Slippage
-            totalCost += estimateSlippage(tradeSize, avgVolumes_[i]);
-        }
+        totalCost += calculateAssetCost(i, tradeSize);
     }
     
     return totalCost;
 }
 
+double TransactionCostModel::calculateAssetCost(int asset, double tradeSize) {
+    if (tradeSize <= 0) return 0.0;
+
+    // Fixed commission per trade
+    double cost = costs_.fixedCommission;
+
+    // Variable commission
+    cost += tradeSize * costs_.variableCommission;
+
+    // Market impact with decay
+    cost += calculateMarketImpactDecay(tradeSize, avgVolumes_[asset], daysToExecute_);
+
+    // Slippage
+    cost += estimateSlippage(tradeSize, avgVolumes_[asset]);
+
+    return cost;
+}
+
 double TransactionCostModel::estimateRebalancingCosts(
     const Matrix& oldWeights, 
     const Matrix& newWeights,
@@ -24,6 +24,9 @@ public:
                             const Matrix& prices,
                             double portfolioValue);
 
+    // Cost of a single asset's trade; calculateTotalCost is the sum over assets
+    double calculateAssetCost(int asset, double tradeSize);
+
     // New helper method for rebalancing
     double estimateRebalancingCosts(const Matrix& oldWeights, 
                                    const Matrix& newWeights,
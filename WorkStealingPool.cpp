@@ -0,0 +1,149 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+
+namespace {
+    // Set on pool threads (and on the caller while it runs as worker 0)
+    thread_local bool insideWorker = false;
+    thread_local size_t currentWorker = 0;
+}
+
+WorkStealingPool::WorkStealingPool(size_t numThreads) {
+    size_t workers = numThreads ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t w = 0; w < workers; ++w) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t w = 1; w < workers; ++w) {
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, w);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, const Task& task, size_t grain) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    if (insideWorker || size() == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i, currentWorker);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(callMutex_);
+
+    // Contiguous runs of chunks per worker keep neighbouring indices
+    // (e.g. configs sharing a window) on the same thread until stolen
+    size_t chunks = (count + grain - 1) / grain;
+    size_t workers = size();
+    for (size_t w = 0; w < workers; ++w) {
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (size_t c = w * chunks / workers; c < (w + 1) * chunks / workers; ++c) {
+            queues_[w]->chunks.push_back(Chunk{c * grain, std::min(count, (c + 1) * grain)});
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        remaining_ = chunks;
+        failed_ = false;
+        error_ = nullptr;
+        activeWorkers_ = workers - 1;
+        ++generation_;
+    }
+    workAvailable_.notify_all();
+
+    insideWorker = true;
+    currentWorker = 0;
+    drain(0);
+    insideWorker = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workDone_.wait(lock, [this] { return remaining_ == 0 && activeWorkers_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Private helper methods
+void WorkStealingPool::workerLoop(size_t worker) {
+    insideWorker = true;
+    currentWorker = worker;
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+
+        drain(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --activeWorkers_;
+        }
+        workDone_.notify_all();
+    }
+}
+
+void WorkStealingPool::drain(size_t worker) {
+    Chunk chunk;
+    while (takeChunk(worker, chunk)) {
+        if (!failed_.load(std::memory_order_relaxed)) {
+            try {
+                for (size_t i = chunk.first; i < chunk.last; ++i) {
+                    (*task_)(i, worker);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+                failed_ = true;
+            }
+        }
+        if (remaining_.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workDone_.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::takeChunk(size_t worker, Chunk& chunk) {
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        Queue& victim = *queues_[(worker + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool for index-space parallel loops. parallelFor splits
+// [0, count) into chunks of `grain` indices and deals them out in
+// contiguous runs, one deque per worker. A worker takes chunks from the back
+// of its own deque and, once that is empty, steals from the front of the
+// others, so uneven task costs (e.g. sweep configs whose constraint
+// enforcement takes many passes) still balance.
+//
+// The calling thread runs as worker 0, and the task receives the worker
+// index so callers can keep per-worker scratch space. The first exception
+// thrown by a task is rethrown from parallelFor after the remaining chunks
+// have been skipped. A parallelFor issued from inside a task runs inline on
+// that worker.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t index, size_t worker)>;
+
+    // numThreads = 0 uses the hardware concurrency
+    explicit WorkStealingPool(size_t numThreads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Workers including the calling thread
+    size_t size() const { return queues_.size(); }
+
+    void parallelFor(size_t count, const Task& task, size_t grain = 1);
+
+private:
+    struct Chunk {
+        size_t first;
+        size_t last;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Current loop, published under mutex_ by bumping generation_
+    std::mutex callMutex_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    const Task* task_{nullptr};
+    size_t generation_{0};
+    size_t activeWorkers_{0};
+    bool stopping_{false};
+    std::atomic<size_t> remaining_{0};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+
+    // Private helper methods
+    void workerLoop(size_t worker);
+    void drain(size_t worker);
+    bool takeChunk(size_t worker, Chunk& chunk);
+};
@@ -5,7 +5,22 @@
 #include "PortfolioRebalancer.hpp"
 #include "RiskMetrics.hpp"
 #include "RiskConstraints.hpp"
+#include "RiskBudgeting.hpp"
 #include "CSVParser.hpp"
+#include "MatrixOperations.hpp"
+#include "ReturnPanel.hpp"
+#include "IncrementalStatistics.hpp"
+#include "TradingCalendar.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
+#include "AsyncWriter.hpp"
+#include "ColumnarStore.hpp"
+#include "ParameterSweep.hpp"
+#include "ResampledFrontier.hpp"
+#include "BlackLitterman.hpp"
+#include "CVaROptimizer.hpp"
+#include "CardinalityOptimizer.hpp"
+#include "PerformanceAttribution.hpp"
 #include <iostream>
 #include <fstream>
 #include <cmath>
@@ -15,6 +30,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <chrono>
+#include <limits>
 
 using namespace QuantLib;
 using namespace std;
@@ -29,27 +45,53 @@ private:
     static const int BENCHMARK_COLUMN = 14;
     static const int TRADING_DAYS_PER_YEAR = 252;
     static const int TRADING_DAYS_PER_MONTH = 21;
+    static const int CSV_PRECISION = 6;
+    static const int REPORT_PRECISION = 4;
     static const double RISK_FREE_RATE = 0.02;  // 2% annual risk-free rate
 
-    // Core data structures
-    Matrix returns_;
-    Matrix excessReturns_;
+    // Core data structures. Return panels are oldest-first and append-only,
+    // so a new day costs O(N); the estimation window is the newest
+    // windowSize_ rows.
+    ReturnPanel returns_;
+    ReturnPanel excessReturns_;
     Matrix covariance_;
     Matrix excessCovariance_;
     Matrix teWeights_;
     Matrix mptWeights_;
     Matrix currentWeights_;
     Matrix historicalWeights_;
-    vector<double> benchmarkReturns_;
+    vector<double> benchmarkReturns_;  // one per return row
     vector<tuple<Real, Real, Real>> efficientFrontierPoints_;
-    vector<string> dates_;
+    ResampledFrontier::Frontier resampledFrontier_;
+    vector<string> dates_;             // one per return row
+    TradingCalendar calendar_;
     vector<string> assetNames_;
     int windowSize_;
+    uint64_t dataVersion_{0};  // bumped when stored rows change; keys the risk cache
+
+    // Optional float32 copies of the return panels (float64 accumulation);
+    // they grow with the double panels
+    bool useSinglePrecision_;
+    ReturnPanelF returnsSingle_;
+    ReturnPanelF excessReturnsSingle_;
+
+    // Rolling-window state for live appends (null until enableLiveStatistics)
+    unique_ptr<IncrementalStatistics> liveReturns_;
+    unique_ptr<IncrementalStatistics> liveExcessReturns_;
+    Matrix expectedReturns_;
+
+    // Black-Litterman prior and views (null until setViews); while set,
+    // expectedReturns_ holds the posterior instead of the window means
+    unique_ptr<BlackLitterman> blackLitterman_;
+    vector<double> equilibriumWeights_;
+    vector<BlackLitterman::View> views_;
+    BlackLitterman::BlackLittermanParameters blackLittermanParameters_;
 
     // Risk management components
     unique_ptr<RiskMetrics> riskMetrics_;
     unique_ptr<RiskConstraints> riskConstraints_;
     RiskMetrics::PortfolioRisk currentRisk_;
+    RiskBudgetAllocator riskBudgetAllocator_;
     map<int, string> sectorMap_;
     vector<double> averageDailyVolume_;
 
@@ -65,16 +107,48 @@ private:
     vector<double> historicalReturns_;
     vector<double> historicalVolatility_;
     vector<double> historicalTrackingError_;
+    vector<int32_t> historicalDays_;
+    vector<string> historicalDates_;
+    vector<double> weightPath_;         // one NUM_ASSETS row per optimization step
 
     // File handling
     string dataFilePath_;
     string outputDirectory_;
+    AsyncFileWriter exportWriter_;
+
+    // Closed-form Markowitz terms of one (mu, sigma): Sigma^-1 mu and
+    // Sigma^-1 u from a single Cholesky factorization, and A = mu'Sigma^-1 mu,
+    // B = mu'Sigma^-1 u, C = u'Sigma^-1 u. Every frontier point reuses them.
+    struct MarkowitzTerms {
+        vector<double> sigmaInvMu;
+        vector<double> sigmaInvU;
+        Real A{0.0};
+        Real B{0.0};
+        Real C{0.0};
+    };
 
     // Core optimization methods
+    MarkowitzTerms factorMarkowitz(const Matrix& mu, const Matrix& sigma, const Matrix& u) {
+        try {
+            PackedCholesky cholesky{SymmetricMatrix(sigma)};
+            
+            MarkowitzTerms terms;
+            terms.sigmaInvMu.resize(NUM_ASSETS);
+            terms.sigmaInvU.resize(NUM_ASSETS);
+            cholesky.solve(mu.begin(), terms.sigmaInvMu.data());
+            cholesky.solve(u.begin(), terms.sigmaInvU.data());
+            terms.A = MatrixOperations::dot(mu.begin(), terms.sigmaInvMu.data(), NUM_ASSETS);
+            terms.B = MatrixOperations::dot(mu.begin(), terms.sigmaInvU.data(), NUM_ASSETS);
+            terms.C = MatrixOperations::dot(u.begin(), terms.sigmaInvU.data(), NUM_ASSETS);
+            return terms;
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in factorMarkowitz: " + string(e.what()));
+        }
+    }
+
     Matrix calculateMarkowitzWeights(
-        const Matrix& mu, 
-        const Matrix& sigma, 
-        const Matrix& u, 
+        const MarkowitzTerms& terms, 
         Real targetReturn, 
         Real& optMu, 
         Real& optSigmaSq) {
@@ -82,16 +156,16 @@ private:
         try {
             Matrix weights(NUM_ASSETS, 1);
             
-            // Original Markowitz calculation
-            Real A = (transpose(mu)*inverse(sigma)*mu)[0][0];
-            Real B = (transpose(mu)*inverse(sigma)*u)[0][0];
-            Real C = (transpose(u)*inverse(sigma)*u)[0][0];
+            const Real A = terms.A, B = terms.B, C = terms.C;
             Real D = A - B * B / C;
             
             optMu = A / C;
             optSigmaSq = 1 / C;
-            weights = inverse(sigma)*u / C * (A - B * targetReturn) / D + 
-                     inverse(sigma)*mu / B * (targetReturn*B - B * B / C) / D;
+            Real onU = (A - B * targetReturn) / (C * D);
+            Real onMu = (targetReturn * B - B * B / C) / (B * D);
+            for (Size i = 0; i < NUM_ASSETS; ++i) {
+                weights[i][0] = onU * terms.sigmaInvU[i] + onMu * terms.sigmaInvMu[i];
+            }
             
             return weights;
         }
@@ -100,12 +174,13 @@ private:
         }
     }
 
-    void calculatePerformanceMetrics() {
+    // windowReturns / windowBenchmark: the estimation window, oldest first
+    void calculatePerformanceMetrics(const Matrix& windowReturns, const Matrix& windowBenchmark) {
         try {
-            // Calculate basic metrics
-            dailyReturn_ = (transpose(teWeights_)*returns_)[0][0];
-            dailyVol_ = sqrt((transpose(teWeights_)*covariance_*teWeights_)[0][0]);
-            trackingError_ = sqrt((transpose(teWeights_)*excessCovariance_*teWeights_)[0][0]);
+            // Calculate basic metrics; the daily return is the latest row's
+            returns_.portfolioReturns(teWeights_.begin(), returns_.rows() - 1, 1, &dailyReturn_);
+            dailyVol_ = sqrt(MatrixOperations::quadForm(covariance_, teWeights_));
+            trackingError_ = sqrt(MatrixOperations::quadForm(excessCovariance_, teWeights_));
             monthlyReturn_ = pow(1 + dailyReturn_, TRADING_DAYS_PER_MONTH) - 1;
             monthlyVol_ = dailyVol_ * sqrt(TRADING_DAYS_PER_MONTH);
 
@@ -113,48 +188,133 @@ private:
             historicalReturns_.push_back(dailyReturn_);
             historicalVolatility_.push_back(dailyVol_);
             historicalTrackingError_.push_back(trackingError_);
+            historicalDays_.push_back(calendar_.empty() ? 0 : calendar_.day(calendar_.size() - 1));
+            historicalDates_.push_back(dates_.empty() ? string() : dates_.back());
+            weightPath_.insert(weightPath_.end(), teWeights_.begin(), teWeights_.end());
 
-            // Calculate comprehensive risk metrics
-            Matrix benchmarkMatrix(NUM_PERIODS, 1);
-            for (size_t i = 0; i < benchmarkReturns_.size(); ++i) {
-                benchmarkMatrix[i][0] = benchmarkReturns_[i];
+            // Calculate comprehensive risk metrics over the estimation window;
+            // in single precision the series is read from the float32 panel
+            RiskMetrics::DataWindow window(dataVersion_, windowStart(), windowSize_);
+            if (useSinglePrecision_) {
+                currentRisk_ = riskMetrics_->calculateRiskMetrics(
+                    window, teWeights_, returnsSingle_, covariance_, excessCovariance_,
+                    windowBenchmark, RISK_FREE_RATE);
+            } else {
+                currentRisk_ = riskMetrics_->calculateRiskMetrics(
+                    window, teWeights_, windowReturns, covariance_, excessCovariance_,
+                    windowBenchmark, RISK_FREE_RATE);
             }
-
-            currentRisk_ = riskMetrics_->calculateRiskMetrics(
-                teWeights_,
-                returns_,
-                covariance_,
-                excessReturns_,
-                excessCovariance_,
-                benchmarkMatrix,
-                RISK_FREE_RATE
-            );
         }
         catch (const exception& e) {
             throw runtime_error("Error in calculatePerformanceMetrics: " + string(e.what()));
         }
     }
 
-    void updateCovariances(const Matrix& windowReturns, const Matrix& windowExcessReturns) {
+    // Sample covariances over rows [firstRow, firstRow + numRows), read in
+    // place from the panels; pairwise-complete where returns are missing
+    void updateCovariances(Size firstRow, Size numRows) {
         try {
-            SequenceStatistics ss, ssd;
-            for (int i = 0; i < windowReturns.rows(); i++) {
-                vector<Real> dailyReturns, excessReturns;
-                for (int j = 0; j < NUM_ASSETS; j++) {
-                    dailyReturns.push_back(windowReturns[i][j]);
-                    excessReturns.push_back(windowExcessReturns[i][j]);
-                }
-                ss.add(dailyReturns);
-                ssd.add(excessReturns);
+            PROFILE_SCOPE("covariance");
+            ALLOCATION_SCOPE("covariance");
+            if (useSinglePrecision_) {
+                // Half the bytes per cell on the T x N sweep; see ReturnPanel.hpp for error bounds
+                covariance_ = returnsSingle_.covariance(firstRow, numRows).toMatrix();
+                excessCovariance_ = excessReturnsSingle_.covariance(firstRow, numRows).toMatrix();
+            } else {
+                covariance_ = returns_.covariance(firstRow, numRows).toMatrix();
+                excessCovariance_ = excessReturns_.covariance(firstRow, numRows).toMatrix();
             }
-            covariance_ = ss.covariance();
-            excessCovariance_ = ssd.covariance();
         }
         catch (const exception& e) {
             throw runtime_error("Error in updateCovariances: " + string(e.what()));
         }
     }
 
+    // First row of the estimation window
+    Size windowStart() const {
+        if (returns_.rows() < static_cast<Size>(windowSize_)) {
+            throw runtime_error("fewer return rows than the estimation window");
+        }
+        return returns_.rows() - windowSize_;
+    }
+
+    void updateExpectedReturns() {
+        try {
+            if (blackLitterman_) {
+                updateBlackLitterman();
+                return;
+            }
+            
+            // Mean returns over the estimation window, each over its observed rows
+            vector<double> means = returns_.columnMeans(windowStart(), windowSize_);
+            expectedReturns_ = Matrix(NUM_ASSETS, 1);
+            copy(means.begin(), means.end(), expectedReturns_.begin());
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in updateExpectedReturns: " + string(e.what()));
+        }
+    }
+
+    // Rows [firstRow, firstRow + numRows) of returns_ and benchmarkReturns_
+    // as dense matrices, for the analytics that take them
+    void panelRows(Size firstRow, Size numRows, Matrix& returns, Matrix& benchmark) const {
+        returns = returns_.toMatrix(firstRow, numRows);
+        benchmark = Matrix(numRows, 1);
+        copy(benchmarkReturns_.begin() + firstRow, benchmarkReturns_.begin() + firstRow + numRows,
+             benchmark.begin());
+    }
+
+    // The full history, oldest row first
+    void chronologicalReturns(Matrix& returns, Matrix& benchmark) const {
+        panelRows(0, returns_.rows(), returns, benchmark);
+    }
+
+    // Refactors the prior for a new covariance_ and copies out the posterior
+    void updateBlackLitterman() {
+        blackLitterman_ = make_unique<BlackLitterman>(
+            SymmetricMatrix(covariance_), equilibriumWeights_, blackLittermanParameters_);
+        blackLitterman_->setViews(views_);
+        const vector<double>& posterior = blackLitterman_->posteriorReturns();
+        expectedReturns_ = Matrix(NUM_ASSETS, 1);
+        copy(posterior.begin(), posterior.end(), expectedReturns_.begin());
+    }
+
+    // Frontier, TE optimization, constraints and metrics from the current
+    // covariance_, excessCovariance_ and expectedReturns_
+    void reoptimize() {
+        try {
+            ALLOCATION_SCOPE("rebalance_step");
+            // Calculate efficient frontier points
+            calculateEfficientFrontier();
+            
+            // Optimize tracking error
+            optimizeTrackingError();
+            
+            // Apply risk constraints over the estimation window; O(windowSize_ N)
+            Matrix windowReturns, windowBenchmark;
+            panelRows(windowStart(), windowSize_, windowReturns, windowBenchmark);
+            
+            teWeights_ = riskConstraints_->enforceConstraints(
+                teWeights_,
+                currentWeights_,
+                windowReturns,
+                covariance_,
+                windowBenchmark,
+                sectorMap_,
+                averageDailyVolume_
+            );
+            
+            // Calculate performance metrics
+            calculatePerformanceMetrics(windowReturns, windowBenchmark);
+            
+            // Store historical weights
+            historicalWeights_ = teWeights_;
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in reoptimize: " + string(e.what()));
+        }
+    }
+
     void initializeSectorMap() {
         sectorMap_ = {
             {0, "Technology"},
@@ -214,7 +374,7 @@ private:
 
 public:
     EnhancedPortfolioOptimizer(const string& filename, int windowSize = 252) 
-        : windowSize_(windowSize), dataFilePath_(filename) {
+        : windowSize_(windowSize), useSinglePrecision_(false), dataFilePath_(filename) {
         try {
             // Initialize risk management components
             riskMetrics_ = make_unique<RiskMetrics>(TRADING_DAYS_PER_YEAR);
@@ -236,7 +396,10 @@ public:
 
             // Load data and initialize portfolio
             loadData(filename);
-            dates_ = extractDates(filename);
+            // Dates in panel order, oldest first
+            vector<string> dates = extractDates(filename);
+            dates_.assign(dates.rbegin(), dates.rend());
+            calendar_ = TradingCalendar(dates_);
             
             // Initialize transaction cost model
             TransactionCostModel::Costs costs;
@@ -260,17 +423,32 @@ public:
 
     void loadData(const string& filename) {
         try {
+            PROFILE_SCOPE("load");
             Parser portfolio(filename);
-            returns_ = Matrix(NUM_PERIODS, NUM_ASSETS);
-            excessReturns_ = Matrix(NUM_PERIODS, NUM_ASSETS);
-            benchmarkReturns_.resize(NUM_PERIODS);
+            ++dataVersion_;
+            returns_ = ReturnPanel(0, NUM_ASSETS);
+            excessReturns_ = ReturnPanel(0, NUM_ASSETS);
+            returns_.reserveRows(NUM_PERIODS);
+            excessReturns_.reserveRows(NUM_PERIODS);
+            benchmarkReturns_.clear();
+            benchmarkReturns_.reserve(NUM_PERIODS);
             
-            for (int i = 0; i < NUM_PERIODS; i++) {
-                benchmarkReturns_[i] = stod(portfolio[i][BENCHMARK_COLUMN]);
+            // Empty fields (asset not trading yet, delisted or halted) become
+            // NaN and are recorded as missing by the panels
+            auto parseField = [](const string& field) {
+                return field.empty() ? numeric_limits<double>::quiet_NaN() : stod(field);
+            };
+            // File rows are newest-first; append them oldest-first
+            vector<double> row(NUM_ASSETS), excess(NUM_ASSETS);
+            for (int i = NUM_PERIODS - 1; i >= 0; i--) {
+                double benchmark = stod(portfolio[i][BENCHMARK_COLUMN]);
                 for (int j = 0; j < NUM_ASSETS; j++) {
-                    returns_[i][j] = stod(portfolio[i][j + FIRST_ASSET_COLUMN]);
-                    excessReturns_[i][j] = returns_[i][j] - benchmarkReturns_[i];
+                    row[j] = parseField(portfolio[i][j + FIRST_ASSET_COLUMN]);
+                    excess[j] = row[j] - benchmark;
                 }
+                returns_.appendRow(row.data());
+                excessReturns_.appendRow(excess.data());
+                benchmarkReturns_.push_back(benchmark);
             }
         }
         catch (const exception& e) {
@@ -278,6 +456,97 @@ public:
         }
     }
 
+    // Memoize risk metrics across repeated report/what-if calls
+    void enableRiskMetricsCache(size_t capacity = 256) {
+        riskMetrics_->enableCache(capacity);
+    }
+
+    // Opt-in float32 storage for the return panels behind covariance estimation
+    // and the risk-metric portfolio series (float64 accumulation throughout)
+    void setSinglePrecision(bool enabled) {
+        useSinglePrecision_ = enabled;
+        ++dataVersion_;
+        if (enabled) {
+            returnsSingle_ = ReturnPanelF(returns_);
+            excessReturnsSingle_ = ReturnPanelF(excessReturns_);
+        } else {
+            returnsSingle_ = ReturnPanelF();
+            excessReturnsSingle_ = ReturnPanelF();
+        }
+    }
+
+    // Seeds the rolling-window statistics from the current estimation
+    // window; afterwards each appendObservation costs O(N^2) for the estimates
+    void enableLiveStatistics(double ewmaLambda = 0.94) {
+        try {
+            liveReturns_ = make_unique<IncrementalStatistics>(NUM_ASSETS, windowSize_, ewmaLambda);
+            liveExcessReturns_ = make_unique<IncrementalStatistics>(NUM_ASSETS, windowSize_, ewmaLambda);
+            
+            vector<double> row(NUM_ASSETS);
+            for (Size t = windowStart(); t < returns_.rows(); t++) {
+                returns_.copyRow(t, row.data());
+                liveReturns_->update(row);
+                excessReturns_.copyRow(t, row.data());
+                liveExcessReturns_->update(row);
+            }
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in enableLiveStatistics: " + string(e.what()));
+        }
+    }
+
+    // Adds one day's asset and benchmark returns as the newest row and
+    // re-optimizes. With live statistics enabled the covariances and mean
+    // returns are updated incrementally instead of re-estimated from the window.
+    void appendObservation(const string& date, const vector<double>& assetReturns, double benchmarkReturn) {
+        try {
+            ALLOCATION_SCOPE("append");
+            if (assetReturns.size() != NUM_ASSETS) {
+                throw runtime_error("Expected " + to_string(NUM_ASSETS) + " asset returns");
+            }
+            
+            calendar_.append(date);
+            
+            vector<double> excess(NUM_ASSETS);
+            for (int j = 0; j < NUM_ASSETS; j++) {
+                excess[j] = assetReturns[j] - benchmarkReturn;
+            }
+            
+            // Append-only: one row per panel, amortized O(N)
+            returns_.appendRow(assetReturns.data());
+            excessReturns_.appendRow(excess.data());
+            benchmarkReturns_.push_back(benchmarkReturn);
+            dates_.push_back(date);
+            if (useSinglePrecision_) {
+                returnsSingle_.appendRow(assetReturns.data());
+                excessReturnsSingle_.appendRow(excess.data());
+            }
+            
+            if (liveReturns_) {
+                liveReturns_->update(assetReturns);
+                liveExcessReturns_->update(excess);
+                covariance_ = liveReturns_->covariance().toMatrix();
+                excessCovariance_ = liveExcessReturns_->covariance().toMatrix();
+                
+                if (blackLitterman_) {
+                    updateBlackLitterman();
+                } else {
+                    vector<double> mean = liveReturns_->mean();
+                    expectedReturns_ = Matrix(NUM_ASSETS, 1);
+                    copy(mean.begin(), mean.end(), expectedReturns_.begin());
+                }
+            } else {
+                updateCovariances(windowStart(), windowSize_);
+                updateExpectedReturns();
+            }
+            
+            reoptimize();
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in appendObservation: " + string(e.what()));
+        }
+    }
+
     vector<string> extractDates(const string& filename) {
         try {
             Parser portfolio(filename);
@@ -296,38 +565,10 @@ public:
     void optimizePortfolio() {
         try {
             // Calculate initial optimization
-            Matrix windowReturns = returns_.block(0, 0, windowSize_, NUM_ASSETS);
-            Matrix windowExcessReturns = excessReturns_.block(0, 0, windowSize_, NUM_ASSETS);
-            
-            updateCovariances(windowReturns, windowExcessReturns);
-            
-            // Calculate efficient frontier points
-            calculateEfficientFrontier();
-            
-            // Optimize tracking error
-            optimizeTrackingError();
-            
-            // Apply risk constraints
-            Matrix benchmarkReturns(NUM_PERIODS, 1);
-            for (int i = 0; i < NUM_PERIODS; i++) {
-                benchmarkReturns[i][0] = benchmarkReturns_[i];
-            }
-            
-            teWeights_ = riskConstraints_->enforceConstraints(
-                teWeights_,
-                currentWeights_,
-                returns_,
-                covariance_,
-                benchmarkReturns,
-                sectorMap_,
-                averageDailyVolume_
-            );
-            
-            // Calculate performance metrics
-            calculatePerformanceMetrics();
+            updateCovariances(windowStart(), windowSize_);
+            updateExpectedReturns();
             
-            // Store historical weights
-            historicalWeights_ = teWeights_;
+            reoptimize();
         }
         catch (const exception& e) {
             throw runtime_error("Error in optimizePortfolio: " + string(e.what()));
@@ -336,21 +577,14 @@ public:
 
     void optimizeTrackingError() {
         try {
-            Matrix mu(NUM_ASSETS, 1);
+            PROFILE_SCOPE("te_optimization");
+            ALLOCATION_SCOPE("te_optimization");
             Matrix u(NUM_ASSETS, 1, 1.0);
             
-            // Calculate mean returns
-            for (int i = 0; i < NUM_ASSETS; i++) {
-                double sum = 0.0;
-                for (int j = 0; j < windowSize_; j++) {
-                    sum += returns_[j][i];
-                }
-                mu[i][0] = sum / windowSize_;
-            }
-            
             // Minimize tracking error
             Real optMu, optSigmaSq;
-            teWeights_ = calculateMarkowitzWeights(mu, excessCovariance_, u, 0.0, optMu, optSigmaSq);
+            teWeights_ = calculateMarkowitzWeights(factorMarkowitz(expectedReturns_, excessCovariance_, u),
+                                                   0.0, optMu, optSigmaSq);
             
             // Apply transaction cost optimization
             teWeights_ = costModel_.optimizeWithCosts(
@@ -367,29 +601,24 @@ public:
 
     void calculateEfficientFrontier() {
         try {
+            PROFILE_SCOPE("frontier");
+            ALLOCATION_SCOPE("frontier");
             const int NUM_POINTS = 50;
-            Matrix mu(NUM_ASSETS, 1);
+            const Matrix& mu = expectedReturns_;
             Matrix u(NUM_ASSETS, 1, 1.0);
             
-            // Calculate mean returns
-            for (int i = 0; i < NUM_ASSETS; i++) {
-                double sum = 0.0;
-                for (int j = 0; j < windowSize_; j++) {
-                    sum += returns_[j][i];
-                }
-                mu[i][0] = sum / windowSize_;
-            }
-            
             // Calculate efficient frontier points
             efficientFrontierPoints_.clear();
             Real minRet = *min_element(mu.begin(), mu.end());
             Real maxRet = *max_element(mu.begin(), mu.end());
             Real step = (maxRet - minRet) / (NUM_POINTS - 1);
             
+            // One factorization for the whole frontier
+            MarkowitzTerms terms = factorMarkowitz(mu, covariance_, u);
             for (int i = 0; i < NUM_POINTS; i++) {
                 Real targetReturn = minRet + i * step;
                 Real optMu, optSigmaSq;
-                Matrix weights = calculateMarkowitzWeights(mu, covariance_, u, targetReturn, optMu, optSigmaSq);
+                Matrix weights = calculateMarkowitzWeights(terms, targetReturn, optMu, optSigmaSq);
                 efficientFrontierPoints_.push_back(make_tuple(targetReturn, sqrt(optSigmaSq), optMu));
             }
         }
@@ -398,67 +627,266 @@ public:
         }
     }
 
-    void exportResultsToCSV(const string& filename) {
+    // Michaud frontier over the estimation window; less sensitive to
+    // estimation error than the point-estimate frontier above
+    void calculateResampledFrontier(
+        const ResampledFrontier::ResampleParameters& parameters = ResampledFrontier::ResampleParameters()) {
+        try {
+            ResampledFrontier frontier(parameters);
+            resampledFrontier_ = frontier.compute(returns_, windowStart(), windowSize_);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in calculateResampledFrontier: " + string(e.what()));
+        }
+    }
+
+    Matrix calculateRiskBudgetWeights(const map<string, double>& sectorBudgets = {}) {
+        try {
+            // Equal risk contribution unless per-sector budgets are supplied
+            RiskBudgetAllocator::Allocation allocation = sectorBudgets.empty()
+                ? riskBudgetAllocator_.equalRiskContribution(covariance_)
+                : riskBudgetAllocator_.allocateToSectorBudgets(covariance_, sectorMap_, sectorBudgets);
+
+            if (!allocation.converged) {
+                throw runtime_error("Risk budgeting solver did not converge");
+            }
+            return allocation.weights;
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in calculateRiskBudgetWeights: " + string(e.what()));
+        }
+    }
+
+    // Confidence intervals for the current portfolio's Sharpe, Sortino, IR
+    // and max drawdown over the full history
+    BlockBootstrap::MetricIntervals bootstrapRiskMetrics(
+        const BlockBootstrap::BootstrapParameters& parameters = BlockBootstrap::BootstrapParameters()) {
         try {
-            ofstream csvFile(outputDirectory_ + filename);
+            Matrix chronological, benchmark;
+            chronologicalReturns(chronological, benchmark);
             
-            // Write header
-            csvFile << "Date,";
-            for (const auto& name : assetNames_) {
-                csvFile << name << "_Weight,";
+            // An unset risk-free rate defaults to the optimizer's, per day; an
+            // explicit 0.0 is kept
+            BlockBootstrap::BootstrapParameters adjusted = parameters;
+            if (!adjusted.riskFreeRate) {
+                adjusted.riskFreeRate = RISK_FREE_RATE / TRADING_DAYS_PER_YEAR;
             }
-            csvFile << "Daily_Return,Monthly_Return,Daily_Vol,Monthly_Vol,Tracking_Error,"
-                   << "Information_Ratio,Sharpe_Ratio,Beta,Alpha,Max_Drawdown,"
-                   << "Total_Long,Total_Short,Net_Exposure,Gross_Exposure,"
-                   << "Estimated_Trading_Cost\n";
+            return riskMetrics_->calculateMetricIntervals(teWeights_, chronological, benchmark, adjusted);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in bootstrapRiskMetrics: " + string(e.what()));
+        }
+    }
 
-            // Write current portfolio data
-            csvFile << fixed << setprecision(6);
+    // Rolling vol, beta, TE, Sharpe and Sortino of the current portfolio:
+    // one chronological row per day (RollingAnalytics::Metric columns)
+    Matrix rollingRiskMetrics(int windowSize) {
+        try {
+            Matrix chronological, benchmark;
+            chronologicalReturns(chronological, benchmark);
             
-            // Date
-            csvFile << dates_.back() << ",";
+            return riskMetrics_->calculateRollingMetrics(teWeights_, chronological, benchmark, windowSize,
+                                                         RISK_FREE_RATE / TRADING_DAYS_PER_YEAR);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in rollingRiskMetrics: " + string(e.what()));
+        }
+    }
+
+    // Monthly Brinson-Fachler (by sectorMap_) and factor attribution of the
+    // current portfolio against benchmarkWeights over the full history;
+    // factorReturns are chronological, one row per return row
+    PerformanceAttribution::Attribution attributePerformance(
+        const vector<double>& benchmarkWeights,
+        const Matrix& factorReturns = Matrix()) {
+        try {
+            Matrix chronological, benchmark;
+            chronologicalReturns(chronological, benchmark);
             
-            // Portfolio weights
-            for (int i = 0; i < NUM_ASSETS; i++) {
-                csvFile << teWeights_[i][0] << ",";
+            PerformanceAttribution attribution(benchmarkWeights, sectorMap_);
+            return attribution.analyzePerformance(teWeights_, chronological, benchmark, factorReturns);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in attributePerformance: " + string(e.what()));
+        }
+    }
+
+    // Minimum-CVaR weights over the full history, plus the stressed panels
+    // of any scenarios given; missing returns count as zero. Scenario shock
+    // vectors must be empty or sized NUM_ASSETS (NUM_ASSETS^2 for
+    // correlation). A positive targetReturn sets a floor on the mean
+    // scenario return.
+    CVaROptimizer::Result optimizeCVaR(
+        const CVaROptimizer::CVaRParameters& parameters = CVaROptimizer::CVaRParameters(),
+        const vector<StressTesting::Scenario>& stressScenarios = vector<StressTesting::Scenario>(),
+        double targetReturn = 0.0) {
+        try {
+            Matrix history = returns_.toMatrix();
+            for (Real& r : history) {
+                if (isnan(r)) r = 0.0;
             }
             
-            // Risk metrics
-            csvFile << dailyReturn_ << ","
-                   << monthlyReturn_ << ","
-                   << dailyVol_ << ","
-                   << monthlyVol_ << ","
-                   << currentRisk_.trackingError << ","
-                   << currentRisk_.informationRatio << ","
-                   << currentRisk_.sharpeRatio << ","
-                   << currentRisk_.beta << ","
-                   << currentRisk_.alpha << ","
-                   << currentRisk_.maxDrawdown << ",";
-
-            // Calculate exposures
-            double totalLong = 0.0, totalShort = 0.0;
-            for (int i = 0; i < NUM_ASSETS; i++) {
-                if (teWeights_[i][0] > 0) totalLong += teWeights_[i][0];
-                else totalShort += abs(teWeights_[i][0]);
+            Matrix scenarios = history;
+            if (!stressScenarios.empty()) {
+                Matrix stressed = StressTesting(history).generateScenarioMatrix(stressScenarios);
+                scenarios = Matrix(history.rows() + stressed.rows(), NUM_ASSETS);
+                copy(history.begin(), history.end(), scenarios.begin());
+                copy(stressed.begin(), stressed.end(), scenarios.begin() + history.rows() * NUM_ASSETS);
             }
-            double netExposure = totalLong - totalShort;
-            double grossExposure = totalLong + totalShort;
+            
+            CVaROptimizer optimizer(parameters);
+            return targetReturn > 0.0 ? optimizer.minimize(scenarios, targetReturn)
+                                      : optimizer.minimize(scenarios);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in optimizeCVaR: " + string(e.what()));
+        }
+    }
 
-            csvFile << totalLong << ","
-                   << totalShort << ","
-                   << netExposure << ","
-                   << grossExposure << ",";
+    // Long-only sparse tracker of benchmarkWeights: between the constraint
+    // limits' minPositions and maxPositions names, within their maximum
+    // position and sector limits
+    CardinalityOptimizer::Result trackWithCardinality(const vector<double>& benchmarkWeights) {
+        try {
+            CardinalityOptimizer optimizer(
+                CardinalityOptimizer::fromLimits(riskConstraints_->getConstraintLimits()));
+            return optimizer.track(SymmetricMatrix(covariance_), benchmarkWeights, sectorMap_);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in trackWithCardinality: " + string(e.what()));
+        }
+    }
 
+    // Black-Litterman expected returns: the equilibrium implied by
+    // equilibriumWeights (the benchmark's holdings) tilted by the views.
+    // Factors covariance_ once and re-optimizes.
+    void setViews(
+        const vector<double>& equilibriumWeights,
+        const vector<BlackLitterman::View>& views,
+        const BlackLitterman::BlackLittermanParameters& parameters = BlackLitterman::BlackLittermanParameters()) {
+        try {
+            equilibriumWeights_ = equilibriumWeights;
+            views_ = views;
+            blackLittermanParameters_ = parameters;
+            updateBlackLitterman();
+            reoptimize();
+        }
+        catch (const exception& e) {
+            blackLitterman_.reset();
+            throw runtime_error("Error in setViews: " + string(e.what()));
+        }
+    }
+
+    // New views on the same prior: reprices on the cached factorization in
+    // O(N K^2), then re-optimizes
+    void updateViews(const vector<BlackLitterman::View>& views) {
+        // On failure the previous views and posterior are restored
+        vector<BlackLitterman::View> previousViews = views_;
+        Matrix previousReturns = expectedReturns_;
+        try {
+            if (!blackLitterman_) {
+                throw runtime_error("no Black-Litterman prior; call setViews first");
+            }
+            blackLitterman_->setViews(views);
+            views_ = views;
+            const vector<double>& posterior = blackLitterman_->posteriorReturns();
+            copy(posterior.begin(), posterior.end(), expectedReturns_.begin());
+            reoptimize();
+        }
+        catch (const exception& e) {
+            if (blackLitterman_) blackLitterman_->setViews(previousViews);
+            views_ = previousViews;
+            expectedReturns_ = previousReturns;
+            throw runtime_error("Error in updateViews: " + string(e.what()));
+        }
+    }
+
+    // Back to window-mean expected returns
+    void clearViews() {
+        blackLitterman_.reset();
+        views_.clear();
+        updateExpectedReturns();
+        reoptimize();
+    }
+
+    // Grid search over risk aversion, window size and constraint limits on
+    // the loaded data, without re-reading the file per combination
+    vector<ParameterSweep::Result> runParameterSweep(
+        const ParameterSweep::Grid& grid,
+        const ParameterSweep::SweepParameters& parameters = ParameterSweep::SweepParameters()) {
+        try {
+            // ParameterSweep expects oldest-first rows
+            Matrix chronological, benchmarkColumn;
+            chronologicalReturns(chronological, benchmarkColumn);
+            vector<double> benchmark(benchmarkColumn.begin(), benchmarkColumn.end());
+            
+            ParameterSweep sweep(chronological, benchmark, sectorMap_, averageDailyVolume_, parameters);
+            return sweep.run(grid);
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error in runParameterSweep: " + string(e.what()));
+        }
+    }
+
+    // Exports snapshot the state they print and hand formatting and I/O to
+    // exportWriter_; call flushExports() to wait for them and surface errors
+    void exportResultsToCSV(const string& filename) {
+        try {
+            PROFILE_SCOPE("report.results_csv");
+            vector<double> weights(teWeights_.begin(), teWeights_.end());
+            
             // Trading costs
             double tradingCost = costModel_.calculateTotalCosts(
                 teWeights_,
                 currentWeights_,
                 averageDailyVolume_
             );
-            csvFile << tradingCost << "\n";
-
-            csvFile.close();
-
+            
+            exportWriter_.submit(outputDirectory_ + filename,
+                [assetNames = assetNames_, date = dates_.back(), weights, risk = currentRisk_,
+                 dailyReturn = dailyReturn_, monthlyReturn = monthlyReturn_,
+                 dailyVol = dailyVol_, monthlyVol = monthlyVol_, tradingCost](TextBuffer& csv) {
+                
+                // Write header
+                csv << "Date,";
+                for (const auto& name : assetNames) {
+                    csv << name << "_Weight,";
+                }
+                csv << "Daily_Return,Monthly_Return,Daily_Vol,Monthly_Vol,Tracking_Error,"
+                    << "Information_Ratio,Sharpe_Ratio,Beta,Alpha,Max_Drawdown,"
+                    << "Total_Long,Total_Short,Net_Exposure,Gross_Exposure,"
+                    << "Estimated_Trading_Cost\n";
+                
+                // Date
+                csv << date << ",";
+                
+                // Portfolio weights
+                for (double weight : weights) {
+                    csv.fixed(weight, CSV_PRECISION) << ",";
+                }
+                
+                // Risk metrics
+                for (double value : {dailyReturn, monthlyReturn, dailyVol, monthlyVol,
+                                     risk.trackingError, risk.informationRatio, risk.sharpeRatio,
+                                     risk.beta, risk.alpha, risk.maxDrawdown}) {
+                    csv.fixed(value, CSV_PRECISION) << ",";
+                }
+                
+                // Calculate exposures
+                double totalLong = 0.0, totalShort = 0.0;
+                for (double weight : weights) {
+                    if (weight > 0) totalLong += weight;
+                    else totalShort += abs(weight);
+                }
+                double netExposure = totalLong - totalShort;
+                double grossExposure = totalLong + totalShort;
+                
+                for (double value : {totalLong, totalShort, netExposure, grossExposure}) {
+                    csv.fixed(value, CSV_PRECISION) << ",";
+                }
+                csv.fixed(tradingCost, CSV_PRECISION) << "\n";
+            });
+            
             // Export historical data if available
             if (!historicalReturns_.empty()) {
                 exportHistoricalDataToCSV(filename.substr(0, filename.find(".csv")) + "_historical.csv");
@@ -471,21 +899,22 @@ public:
 
     void exportHistoricalDataToCSV(const string& filename) {
         try {
-            ofstream csvFile(outputDirectory_ + filename);
-            
-            // Write header
-            csvFile << "Date,Daily_Return,Daily_Vol,Tracking_Error\n";
-            
-            // Write historical data
-            csvFile << fixed << setprecision(6);
-            for (size_t i = 0; i < historicalReturns_.size(); ++i) {
-                csvFile << dates_[i] << ","
-                       << historicalReturns_[i] << ","
-                       << historicalVolatility_[i] << ","
-                       << historicalTrackingError_[i] << "\n";
-            }
-            
-            csvFile.close();
+            PROFILE_SCOPE("report.historical_csv");
+            exportWriter_.submit(outputDirectory_ + filename,
+                [dates = historicalDates_, returns = historicalReturns_, volatility = historicalVolatility_,
+                 trackingError = historicalTrackingError_](TextBuffer& csv) {
+                
+                // Write header
+                csv << "Date,Daily_Return,Daily_Vol,Tracking_Error\n";
+                
+                // Write historical data
+                for (size_t i = 0; i < returns.size(); ++i) {
+                    csv << dates[i] << ",";
+                    csv.fixed(returns[i], CSV_PRECISION) << ",";
+                    csv.fixed(volatility[i], CSV_PRECISION) << ",";
+                    csv.fixed(trackingError[i], CSV_PRECISION) << "\n";
+                }
+            });
         }
         catch (const exception& e) {
             throw runtime_error("Error exporting historical data to CSV: " + string(e.what()));
@@ -494,69 +923,143 @@ public:
 
     void generateRiskReport(const string& filename) {
         try {
-            ofstream report(outputDirectory_ + filename);
-            report << fixed << setprecision(4);
-            
-            // Portfolio summary
-            report << "Portfolio Risk Analysis Report\n";
-            report << "==============================\n\n";
-            
-            // Risk metrics
-            report << "Risk Metrics:\n";
-            report << "--------------\n";
-            report << "Daily Volatility: " << currentRisk_.dailyVol * 100 << "%\n";
-            report << "Monthly Volatility: " << currentRisk_.monthlyVol * 100 << "%\n";
-            report << "Annualized Volatility: " << currentRisk_.annualizedVol * 100 << "%\n";
-            report << "Tracking Error: " << currentRisk_.trackingError * 100 << "%\n";
-            report << "Information Ratio: " << currentRisk_.informationRatio << "\n";
-            report << "Sharpe Ratio: " << currentRisk_.sharpeRatio << "\n";
-            report << "Sortino Ratio: " << currentRisk_.sortino << "\n";
-            report << "Maximum Drawdown: " << currentRisk_.maxDrawdown * 100 << "%\n";
-            report << "Beta: " << currentRisk_.beta << "\n";
-            report << "Alpha: " << currentRisk_.alpha * 100 << "%\n\n";
-            
-            // Position analysis
-            report << "Position Analysis:\n";
-            report << "-----------------\n";
-            for (size_t i = 0; i < assetNames_.size(); i++) {
-                report << assetNames_[i] << ": " << teWeights_[i][0] * 100 << "%\n";
-            }
-            report << "\n";
+            PROFILE_SCOPE("report.risk_report");
+            vector<double> weights(teWeights_.begin(), teWeights_.end());
             
-            // Sector exposures
-            report << "Sector Exposures:\n";
-            report << "----------------\n";
             map<string, double> sectorExposures;
             for (int i = 0; i < NUM_ASSETS; i++) {
                 sectorExposures[sectorMap_[i]] += teWeights_[i][0];
             }
-            for (const auto& exposure : sectorExposures) {
-                report << exposure.first << ": " << exposure.second * 100 << "%\n";
-            }
-            report << "\n";
             
-            // Transaction cost analysis
-            report << "Transaction Cost Analysis:\n";
-            report << "------------------------\n";
             double tradingCost = costModel_.calculateTotalCosts(
                 teWeights_,
                 currentWeights_,
                 averageDailyVolume_
             );
-            report << "Estimated Trading Costs: " << tradingCost * 10000 << " bps\n\n";
             
-            report.close();
+            exportWriter_.submit(outputDirectory_ + filename,
+                [assetNames = assetNames_, weights, sectorExposures, risk = currentRisk_,
+                 tradingCost](TextBuffer& report) {
+                
+                auto percent = [&report](double value) -> TextBuffer& {
+                    return report.fixed(value * 100, REPORT_PRECISION) << "%\n";
+                };
+                
+                // Portfolio summary
+                report << "Portfolio Risk Analysis Report\n";
+                report << "==============================\n\n";
+                
+                // Risk metrics
+                report << "Risk Metrics:\n";
+                report << "--------------\n";
+                report << "Daily Volatility: "; percent(risk.dailyVol);
+                report << "Monthly Volatility: "; percent(risk.monthlyVol);
+                report << "Annualized Volatility: "; percent(risk.annualizedVol);
+                report << "Tracking Error: "; percent(risk.trackingError);
+                report << "Information Ratio: ";
+                report.fixed(risk.informationRatio, REPORT_PRECISION) << "\n";
+                report << "Sharpe Ratio: ";
+                report.fixed(risk.sharpeRatio, REPORT_PRECISION) << "\n";
+                report << "Sortino Ratio: ";
+                report.fixed(risk.sortino, REPORT_PRECISION) << "\n";
+                report << "Maximum Drawdown: "; percent(risk.maxDrawdown);
+                report << "Beta: ";
+                report.fixed(risk.beta, REPORT_PRECISION) << "\n";
+                report << "Alpha: "; percent(risk.alpha);
+                report << "\n";
+                
+                // Position analysis
+                report << "Position Analysis:\n";
+                report << "-----------------\n";
+                for (size_t i = 0; i < assetNames.size(); i++) {
+                    report << assetNames[i] << ": "; percent(weights[i]);
+                }
+                report << "\n";
+                
+                // Sector exposures
+                report << "Sector Exposures:\n";
+                report << "----------------\n";
+                for (const auto& exposure : sectorExposures) {
+                    report << exposure.first << ": "; percent(exposure.second);
+                }
+                report << "\n";
+                
+                // Transaction cost analysis
+                report << "Transaction Cost Analysis:\n";
+                report << "------------------------\n";
+                report << "Estimated Trading Costs: ";
+                report.fixed(tradingCost * 10000, REPORT_PRECISION) << " bps\n\n";
+            });
         }
         catch (const exception& e) {
             throw runtime_error("Error generating risk report: " + string(e.what()));
         }
     }
 
+    // Binary columnar export of the weight path and the risk time series
+    // (see ColumnarStore.hpp). The weight path is stored long and
+    // asset-major: weights.asset holds dictionary ids, and consecutive
+    // weights.value entries follow one asset through time, which keeps the
+    // XOR deltas small between rebalances.
+    void exportResultsToColumnar(const string& filename, bool compress = true) {
+        try {
+            PROFILE_SCOPE("report.columnar");
+            exportWriter_.submit(outputDirectory_ + filename,
+                [assetNames = assetNames_, days = historicalDays_, weightPath = weightPath_,
+                 returns = historicalReturns_, volatility = historicalVolatility_,
+                 trackingError = historicalTrackingError_, compress](TextBuffer& out) {
+                
+                ColumnarWriter writer(compress);
+                writer.setAssets(assetNames);
+                
+                // Weight path
+                size_t steps = days.size();
+                vector<int32_t> pathDays(steps * NUM_ASSETS);
+                vector<uint32_t> pathAssets(steps * NUM_ASSETS);
+                vector<double> pathWeights(steps * NUM_ASSETS);
+                for (size_t j = 0; j < NUM_ASSETS; j++) {
+                    for (size_t t = 0; t < steps; t++) {
+                        size_t k = j * steps + t;
+                        pathDays[k] = days[t];
+                        pathAssets[k] = static_cast<uint32_t>(j);
+                        pathWeights[k] = weightPath[t * NUM_ASSETS + j];
+                    }
+                }
+                writer.addDates("weights.date", pathDays);
+                writer.addAssetIds("weights.asset", pathAssets);
+                writer.addFloat64("weights.value", pathWeights);
+                
+                // Risk time series
+                writer.addDates("series.date", days);
+                writer.addFloat64("series.daily_return", returns);
+                writer.addFloat64("series.daily_vol", volatility);
+                writer.addFloat64("series.tracking_error", trackingError);
+                
+                writer.serialize(out);
+            });
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error exporting columnar results: " + string(e.what()));
+        }
+    }
+
+    // Waits for queued exports; rethrows the first write error
+    void flushExports() {
+        try {
+            exportWriter_.flush();
+        }
+        catch (const exception& e) {
+            throw runtime_error("Error writing exports: " + string(e.what()));
+        }
+    }
+
     // Getter methods
     Matrix getOptimizedWeights() const { return teWeights_; }
     Matrix getCurrentWeights() const { return currentWeights_; }
+    const TradingCalendar& getCalendar() const { return calendar_; }
     RiskMetrics::PortfolioRisk getCurrentRisk() const { return currentRisk_; }
     vector<tuple<Real, Real, Real>> getEfficientFrontier() const { return efficientFrontierPoints_; }
+    const ResampledFrontier::Frontier& getResampledFrontier() const { return resampledFrontier_; }
 };
 
 int main(int argc, char* argv[]) {
@@ -578,6 +1081,8 @@ int main(int argc, char* argv[]) {
         // Generate reports
         optimizer.generateRiskReport("portfolio_risk_report.txt");
         optimizer.exportResultsToCSV("portfolio_results.csv");
+        optimizer.exportResultsToColumnar("portfolio_results.pfc");
+        optimizer.flushExports();
         
         // Output summary to console
         auto risk = optimizer.getCurrentRisk();